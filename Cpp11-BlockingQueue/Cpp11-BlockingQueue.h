@@ -2,7 +2,7 @@
 #define CPP11_BLOCKINGQUEUE_H
 ///////////////////////////////////////////////////////////////
 // Cpp11-BlockingQueue.h - Thread-safe Blocking Queue        //
-// ver 1.3                                                   //
+// ver 1.9                                                   //
 // Jim Fawcett, CSE687 - Object Oriented Design, Spring 2015 //
 ///////////////////////////////////////////////////////////////
 /*
@@ -12,7 +12,26 @@
  * Its purpose is to support sending messages between threads.
  * It is implemented using C++11 threading constructs including 
  * std::condition_variable and std::mutex.  The underlying storage
- * is provided by the non-thread-safe std::queue<T>.
+ * is a std::vector<T>, read from a moving head index.  deQAll()
+ * swaps that vector with the caller's empty batch, so the two
+ * trade capacity back and forth and, once both have grown to the
+ * largest backlog, enqueueing no longer allocates.
+ *
+ * Storage isn't kept for a burst that has passed.  Whenever the queue
+ * empties, a vector holding more than retainFloor elements of space
+ * and over four times the elements that last passed through it is
+ * replaced by one sized for those elements.  So after a burst drains,
+ * storage returns to at most max(retainFloor, 4 x backlog) within a
+ * drain or two.  Callers swapping batches with deQAll() should bound
+ * their batch the same way.
+ *
+ * peekUnsafe(f) visits queued elements without taking the mutex, for
+ * crash handlers that must not block.  Every operation publishes the
+ * storage address and live range through atomics, and hides them
+ * while elements are being moved, destroyed, or reallocated, so a
+ * reader never follows a stale storage pointer.  Elements may still
+ * change while they are being read, so use it only when the process
+ * is going down anyway.
  *
  * Required Files:
  * ---------------
@@ -24,6 +43,27 @@
  *
  * Maintenance History:
  * --------------------
+ * ver 1.9 : 16 Oct 2026
+ * - storage is released once drained, when it is far larger than the
+ *   backlog, see retainFloor
+ * ver 1.8 : 16 Oct 2026
+ * - added tryDeQIf(), taking the front element only if a predicate
+ *   accepts it, without allocating
+ * ver 1.7 : 16 Oct 2026
+ * - added deQAllFor(), deQAll() giving up after a timeout
+ * ver 1.6 : 16 Oct 2026
+ * - added peekUnsafe(), reading queued elements without the mutex
+ * ver 1.5 : 16 Oct 2026
+ * - storage changed from std::queue<T> to a reused std::vector<T>,
+ *   so steady state enQ() doesn't allocate
+ * - deQ() moves elements out instead of copying them
+ * ver 1.4 : 16 Oct 2026
+ * - added enQ(T&&) so callers can move elements into the queue
+ * - added deQAll() and tryDeQAll() to drain many elements under
+ *   one lock
+ * - enQ() returns the element's ticket, its 1-based position in the
+ *   sequence of all elements ever enqueued, and enqueued() returns
+ *   the latest ticket.  Tickets are assigned in deQ order.
  * ver 1.3 : 04 Mar 2016
  * - changed behavior of front() to throw exception
  *   on empty queue.
@@ -42,26 +82,52 @@
 #include <condition_variable>
 #include <mutex>
 #include <thread>
-#include <queue>
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
 template <typename T>
 class BlockingQueue {
 public:
+  static constexpr size_t retainFloor = 1024;
+
   BlockingQueue() {}
   BlockingQueue(BlockingQueue<T>&& bq);
   BlockingQueue<T>& operator=(BlockingQueue<T>&& bq);
   BlockingQueue(const BlockingQueue<T>&) = delete;
   BlockingQueue<T>& operator=(const BlockingQueue<T>&) = delete;
   T deQ();
-  void enQ(const T& t);
+  size_t deQAll(std::vector<T>& batch, size_t maxCount = SIZE_MAX);
+  size_t deQAllFor(std::vector<T>& batch, size_t maxCount, std::chrono::microseconds timeout);
+  size_t tryDeQAll(std::vector<T>& batch, size_t maxCount = SIZE_MAX);
+  template<typename P>
+  bool tryDeQIf(T& t, P pred);
+  size_t enQ(const T& t);
+  size_t enQ(T&& t);
+  size_t enqueued();
   T& front();
   void clear();
   size_t size();
+  template<typename F>
+  size_t peekUnsafe(F f) const;
 private:
-  std::queue<T> q_;
+  template<typename U>
+  size_t push(U&& u);
+  T pop();
+  size_t drain(std::vector<T>& batch, size_t maxCount);
+  void trim(size_t used);
+  void hideView();
+  void publishView();
+  std::vector<T> q_;
+  size_t head_ = 0;
+  size_t enqCount_ = 0;
+  std::atomic<const T*> viewData_{ nullptr };
+  std::atomic<size_t> viewBegin_{ 0 };
+  std::atomic<size_t> viewEnd_{ 0 };
   std::mutex mtx_;
   std::condition_variable cv_;
 };
@@ -71,9 +137,13 @@ template<typename T>
 BlockingQueue<T>::BlockingQueue(BlockingQueue<T>&& bq) // need to lock so can't initialize
 {
   std::lock_guard<std::mutex> l(mtx_);
-  q_ = bq.q_;
-  while (bq.q_.size() > 0)  // clear bq
-    bq.q_.pop();
+  bq.hideView();
+  q_ = std::move(bq.q_);
+  head_ = bq.head_;
+  bq.q_.clear();  // clear bq
+  bq.head_ = 0;
+  bq.publishView();
+  publishView();
   /* can't copy  or move mutex or condition variable, so use default members */
 }
 //----< move assignment >----------------------------------------------
@@ -83,12 +153,88 @@ BlockingQueue<T>& BlockingQueue<T>::operator=(BlockingQueue<T>&& bq)
 {
   if (this == &bq) return *this;
   std::lock_guard<std::mutex> l(mtx_);
-  q_ = bq.q_;
-  while (bq.q_.size() > 0)  // clear bq
-    bq.q_.pop();
+  hideView();
+  bq.hideView();
+  q_ = std::move(bq.q_);
+  head_ = bq.head_;
+  bq.q_.clear();  // clear bq
+  bq.head_ = 0;
+  bq.publishView();
+  publishView();
   /* can't move assign mutex or condition variable so use target's */
   return *this;
 }
+//----< hide storage from peekUnsafe, caller holds lock >-------------
+
+template<typename T>
+void BlockingQueue<T>::hideView()
+{
+  viewData_.store(nullptr, std::memory_order_release);
+}
+//----< show storage to peekUnsafe, caller holds lock >---------------
+
+template<typename T>
+void BlockingQueue<T>::publishView()
+{
+  viewBegin_.store(head_, std::memory_order_relaxed);
+  viewEnd_.store(q_.size(), std::memory_order_relaxed);
+  viewData_.store(q_.data(), std::memory_order_release);
+}
+//----< append element, caller holds lock >---------------------------
+/*
+ *  Elements before head_ have been taken.  When the vector is full
+ *  and at least half of it is taken, live elements slide down
+ *  instead of growing the vector.
+ */
+template<typename T>
+template<typename U>
+size_t BlockingQueue<T>::push(U&& u)
+{
+  bool moving = q_.size() == q_.capacity();
+  if (moving)
+    hideView();
+  if (head_ > 0 && moving && 2 * head_ >= q_.size())
+  {
+    q_.erase(q_.begin(), q_.begin() + head_);
+    head_ = 0;
+  }
+  q_.push_back(std::forward<U>(u));
+  publishView();
+  return ++enqCount_;
+}
+//----< take front element, caller holds lock >------------------------
+
+template<typename T>
+T BlockingQueue<T>::pop()
+{
+  viewBegin_.store(head_ + 1, std::memory_order_release);
+  T temp = std::move(q_[head_]);
+  if (++head_ == q_.size())
+  {
+    hideView();
+    size_t used = q_.size();
+    q_.clear();
+    head_ = 0;
+    trim(used);
+  }
+  publishView();
+  return temp;
+}
+//----< shrink empty storage far larger than used, caller holds lock >
+/*
+ *  used is the number of elements that last passed through the
+ *  storage, none says nothing about the backlog, so keeps it.  The
+ *  view must be hidden.
+ */
+template<typename T>
+void BlockingQueue<T>::trim(size_t used)
+{
+  if (used == 0 || q_.capacity() <= retainFloor || q_.capacity() <= 4 * used)
+    return;
+  std::vector<T> fresh;
+  fresh.reserve(used);
+  q_.swap(fresh);
+}
 //----< remove element from front of queue >---------------------------
 
 template<typename T>
@@ -105,30 +251,111 @@ T BlockingQueue<T>::deQ()
        signaled state.
      std::lock_quard does not have public lock and unlock functions.
    */
-  if(q_.size() > 0)
+  if(q_.size() > head_)
+    return pop();
+
+  // may have spurious returns so loop on !condition
+
+  while (q_.size() == head_)
+    cv_.wait(l, [this] () { return q_.size() > head_; });
+  return pop();
+}
+//----< append up to maxCount elements to batch, caller holds lock >--
+/*
+ *  When everything fits in an empty batch the whole queue is swapped
+ *  out, so the time spent holding the lock doesn't depend on queue
+ *  length.  Otherwise elements are moved, at most maxCount of them.
+ */
+template<typename T>
+size_t BlockingQueue<T>::drain(std::vector<T>& batch, size_t maxCount)
+{
+  size_t count = q_.size() - head_;
+  if (count <= maxCount && head_ == 0 && batch.empty())
   {
-    T temp = q_.front();
-    q_.pop();
-    return temp;
+    hideView();
+    batch.swap(q_);
+    trim(count);
+    publishView();
+    return count;
   }
-  // may have spurious returns so loop on !condition
+  if (count > maxCount)
+    count = maxCount;
+  for (size_t i = 0; i < count; ++i)
+    batch.push_back(pop());
+  return count;
+}
+//----< append up to maxCount elements to batch, blocking if empty >--
 
-  while (q_.size() == 0)
-    cv_.wait(l, [this] () { return q_.size() > 0; });
-  T temp = q_.front();
-  q_.pop();
-  return temp;
+template<typename T>
+size_t BlockingQueue<T>::deQAll(std::vector<T>& batch, size_t maxCount)
+{
+  std::unique_lock<std::mutex> l(mtx_);
+  cv_.wait(l, [this]() { return q_.size() > head_; });
+  return drain(batch, maxCount);
+}
+//----< append up to maxCount elements, waiting at most timeout >----
+
+template<typename T>
+size_t BlockingQueue<T>::deQAllFor(std::vector<T>& batch, size_t maxCount, std::chrono::microseconds timeout)
+{
+  std::unique_lock<std::mutex> l(mtx_);
+  if (!cv_.wait_for(l, timeout, [this]() { return q_.size() > head_; }))
+    return 0;
+  return drain(batch, maxCount);
+}
+//----< append up to maxCount elements to batch, never blocks >-------
+
+template<typename T>
+size_t BlockingQueue<T>::tryDeQAll(std::vector<T>& batch, size_t maxCount)
+{
+  std::lock_guard<std::mutex> l(mtx_);
+  return drain(batch, maxCount);
+}
+//----< move front element to t if pred(front) is true, never blocks >
+
+template<typename T>
+template<typename P>
+bool BlockingQueue<T>::tryDeQIf(T& t, P pred)
+{
+  std::lock_guard<std::mutex> l(mtx_);
+  if (q_.size() == head_ || !pred(static_cast<const T&>(q_[head_])))
+    return false;
+  t = pop();
+  return true;
 }
 //----< push element onto back of queue >------------------------------
 
 template<typename T>
-void BlockingQueue<T>::enQ(const T& t)
+size_t BlockingQueue<T>::enQ(const T& t)
+{
+  size_t ticket;
+  {
+    std::unique_lock<std::mutex> l(mtx_);
+    ticket = push(t);
+  }
+  cv_.notify_one();
+  return ticket;
+}
+//----< move element onto back of queue >------------------------------
+
+template<typename T>
+size_t BlockingQueue<T>::enQ(T&& t)
 {
+  size_t ticket;
   {
     std::unique_lock<std::mutex> l(mtx_);
-    q_.push(t);
+    ticket = push(std::move(t));
   }
   cv_.notify_one();
+  return ticket;
+}
+//----< return ticket of most recently enqueued element >--------------
+
+template<typename T>
+size_t BlockingQueue<T>::enqueued()
+{
+  std::lock_guard<std::mutex> l(mtx_);
+  return enqCount_;
 }
 //----< peek at next item to be popped >-------------------------------
 
@@ -136,8 +363,8 @@ template <typename T>
 T& BlockingQueue<T>::front()
 {
   std::lock_guard<std::mutex> l(mtx_);
-  if(q_.size() > 0)
-    return q_.front();
+  if(q_.size() > head_)
+    return q_[head_];
   throw std::exception("attempt to deQue empty queue");
 }
 //----< remove all elements from queue >-------------------------------
@@ -146,8 +373,10 @@ template <typename T>
 void BlockingQueue<T>::clear()
 {
   std::lock_guard<std::mutex> l(mtx_);
-  while (q_.size() > 0)
-    q_.pop();
+  hideView();
+  q_.clear();
+  head_ = 0;
+  publishView();
 }
 //----< return number of elements in queue >---------------------------
 
@@ -155,7 +384,28 @@ template<typename T>
 size_t BlockingQueue<T>::size()
 {
   std::lock_guard<std::mutex> l(mtx_);
-  return q_.size();
+  return q_.size() - head_;
+}
+//----< visit queued elements without locking, returns count >-------
+/*
+ *  For crash handlers only, see Package Operations.  f is called
+ *  with const T& for each element, oldest first.
+ */
+template<typename T>
+template<typename F>
+size_t BlockingQueue<T>::peekUnsafe(F f) const
+{
+  const T* pData = viewData_.load(std::memory_order_acquire);
+  if (pData == nullptr)
+    return 0;
+  size_t begin = viewBegin_.load(std::memory_order_acquire);
+  size_t end = viewEnd_.load(std::memory_order_acquire);
+  if (viewData_.load(std::memory_order_acquire) != pData)
+    return 0;
+  size_t count = 0;
+  for (size_t i = begin; i < end; ++i, ++count)
+    f(pData[i]);
+  return count;
 }
 
 #endif
@@ -0,0 +1,201 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////
+// TimestampFormatter.h - fast ISO-8601 timestamps                 //
+// ver 1.0                                                         //
+// Jim Fawcett, CSE687 - Object Oriented Design, Spring 2017       //
+/////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * TimestampFormatter writes ISO-8601 timestamps, e.g.,
+ *   2026-10-16T19:53:35.123456-04:00
+ *   2026-10-16T23:53:35.123456789Z
+ * into a caller-supplied buffer, with no allocation and no shared
+ * static state:
+ * - the "YYYY-MM-DDTHH:MM:SS" text is cached and rebuilt only when
+ *   the second changes, so most calls just write sub-second digits
+ * - dates are computed arithmetically from the epoch, not with
+ *   gmtime or localtime
+ * - Zone::local uses a cached UTC offset, refreshed once an hour
+ *
+ * Each instance caches for one thread, so use one instance per
+ * thread, e.g., a thread_local.
+ *
+ * Required Files:
+ * ---------------
+ *   TimestampFormatter.h
+ *
+ * Maintenance History:
+ * --------------------
+ * ver 1.0 : 16 Oct 2026
+ * - first release
+*/
+
+#include <chrono>
+#include <ctime>
+#include <cstdint>
+#include <cstring>
+
+namespace Utilities
+{
+  class TimestampFormatter
+  {
+  public:
+    using SysClock = std::chrono::system_clock;
+    enum class Precision { micro = 6, nano = 9 };
+    enum class Zone { utc, local };
+
+    static constexpr size_t bufferSize = 40;
+
+    size_t format(char* buf, size_t size, Precision p = Precision::micro, Zone z = Zone::local);
+    size_t format(
+      char* buf, size_t size, SysClock::time_point tp,
+      Precision p = Precision::micro, Zone z = Zone::local
+    );
+  private:
+    static void writeDigits(char* pos, uint64_t value, size_t count);
+    static void civilFromDays(int64_t days, int64_t& y, unsigned& m, unsigned& d);
+    static int64_t daysFromCivil(int64_t y, unsigned m, unsigned d);
+    int32_t utcOffset(int64_t sec);
+    void refresh(int64_t sec, Zone z);
+
+    int64_t cachedSec_ = INT64_MIN;
+    Zone cachedZone_ = Zone::utc;
+    int64_t offsetHour_ = INT64_MIN;
+    int32_t offsetSecs_ = 0;
+    char prefix_[20] = {};
+    char zone_[8] = {};
+    size_t zoneLen_ = 0;
+  };
+
+  //----< write count decimal digits of value, zero padded >---------
+
+  inline void TimestampFormatter::writeDigits(char* pos, uint64_t value, size_t count)
+  {
+    for (size_t i = count; i > 0; --i)
+    {
+      pos[i - 1] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    }
+  }
+  //----< convert days since 1970-01-01 to year, month, day >--------
+  /*
+   *  Howard Hinnant's civil_from_days algorithm
+   */
+  inline void TimestampFormatter::civilFromDays(int64_t days, int64_t& y, unsigned& m, unsigned& d)
+  {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned doe = static_cast<unsigned>(days - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2 ? 1 : 0);
+  }
+  //----< convert year, month, day to days since 1970-01-01 >--------
+
+  inline int64_t TimestampFormatter::daysFromCivil(int64_t y, unsigned m, unsigned d)
+  {
+    y -= m <= 2 ? 1 : 0;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = static_cast<unsigned>(y - era * 400);
+    unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+  }
+  //----< local UTC offset in seconds, refreshed once an hour >------
+
+  inline int32_t TimestampFormatter::utcOffset(int64_t sec)
+  {
+    int64_t hour = sec / 3600;
+    if (hour == offsetHour_)
+      return offsetSecs_;
+    std::time_t t = static_cast<std::time_t>(sec);
+    std::tm lt;
+#ifdef _WIN32
+    localtime_s(&lt, &t);
+#else
+    localtime_r(&t, &lt);
+#endif
+    int64_t localSec =
+      daysFromCivil(lt.tm_year + 1900, lt.tm_mon + 1, lt.tm_mday) * 86400 +
+      lt.tm_hour * 3600 + lt.tm_min * 60 + lt.tm_sec;
+    offsetSecs_ = static_cast<int32_t>(localSec - sec);
+    offsetHour_ = hour;
+    return offsetSecs_;
+  }
+  //----< rebuild cached date and time of day text >-----------------
+
+  inline void TimestampFormatter::refresh(int64_t sec, Zone z)
+  {
+    int32_t offset = (z == Zone::local) ? utcOffset(sec) : 0;
+    int64_t local = sec + offset;
+    int64_t days = (local >= 0 ? local : local - 86399) / 86400;
+    int64_t secOfDay = local - days * 86400;
+    int64_t y;
+    unsigned m, d;
+    civilFromDays(days, y, m, d);
+
+    writeDigits(prefix_, static_cast<uint64_t>(y), 4);
+    prefix_[4] = '-';
+    writeDigits(prefix_ + 5, m, 2);
+    prefix_[7] = '-';
+    writeDigits(prefix_ + 8, d, 2);
+    prefix_[10] = 'T';
+    writeDigits(prefix_ + 11, static_cast<uint64_t>(secOfDay / 3600), 2);
+    prefix_[13] = ':';
+    writeDigits(prefix_ + 14, static_cast<uint64_t>(secOfDay / 60 % 60), 2);
+    prefix_[16] = ':';
+    writeDigits(prefix_ + 17, static_cast<uint64_t>(secOfDay % 60), 2);
+
+    if (z == Zone::utc)
+    {
+      zone_[0] = 'Z';
+      zoneLen_ = 1;
+    }
+    else
+    {
+      int32_t absOffset = offset < 0 ? -offset : offset;
+      zone_[0] = offset < 0 ? '-' : '+';
+      writeDigits(zone_ + 1, static_cast<uint64_t>(absOffset / 3600), 2);
+      zone_[3] = ':';
+      writeDigits(zone_ + 4, static_cast<uint64_t>(absOffset / 60 % 60), 2);
+      zoneLen_ = 6;
+    }
+    cachedSec_ = sec;
+    cachedZone_ = z;
+  }
+  //----< format time point, returns length or 0 if buf too small >--
+
+  inline size_t TimestampFormatter::format(
+    char* buf, size_t size, SysClock::time_point tp, Precision p, Zone z
+  )
+  {
+    size_t digits = static_cast<size_t>(p);
+    size_t length = 19 + 1 + digits + (z == Zone::utc ? 1 : 6);
+    if (size < length)
+      return 0;
+    auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch());
+    int64_t ns = sinceEpoch.count();
+    int64_t sec = (ns >= 0 ? ns : ns - 999999999) / 1000000000;
+    uint64_t subSec = static_cast<uint64_t>(ns - sec * 1000000000);
+    if (sec != cachedSec_ || z != cachedZone_)
+      refresh(sec, z);
+
+    std::memcpy(buf, prefix_, 19);
+    buf[19] = '.';
+    if (p == Precision::micro)
+      subSec /= 1000;
+    writeDigits(buf + 20, subSec, digits);
+    std::memcpy(buf + 20 + digits, zone_, zoneLen_);
+    return length;
+  }
+  //----< format current time >--------------------------------------
+
+  inline size_t TimestampFormatter::format(char* buf, size_t size, Precision p, Zone z)
+  {
+    return format(buf, size, SysClock::now(), p, z);
+  }
+}
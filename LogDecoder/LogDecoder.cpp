@@ -0,0 +1,52 @@
+/////////////////////////////////////////////////////////////////////////
+// LogDecoder.cpp - Expands binary logs written by deferred posts      //
+// ver 1.1                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Reads a binary log written by QTestLogger::setDeferredSink, or by
+   a logger to a SinkFormat::binary sink, and writes its records to
+   std::cout as text, or with --json as one JSON object per line.
+
+   usage: LogDecoder [--json] <binary log file>
+
+   Dependencies:
+  ---------------
+   StructuredLog.h
+   DeferredLog.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.1 : 16 Oct 2026
+   - decodes structured and text frames, added --json
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include "../TestLogger/StructuredLog.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+  bool json = argc > 1 && std::string(argv[1]) == "--json";
+  int fileArg = json ? 2 : 1;
+  if (argc <= fileArg) {
+    std::cout << "\n  usage: LogDecoder [--json] <binary log file>\n";
+    return 1;
+  }
+  std::ifstream in(argv[fileArg], std::ios::in | std::ios::binary);
+  if (!in.good()) {
+    std::cout << "\n  can't open \"" << argv[fileArg] << "\"\n";
+    return 1;
+  }
+  if (json) {
+    Test::decodeLog(in, std::cout, Test::SinkFormat::json);
+    return 0;
+  }
+  size_t count = Test::decodeLog(in, std::cout);
+  std::cout << "\n\n  decoded " << count << " records\n";
+  return 0;
+}
@@ -0,0 +1,97 @@
+/////////////////////////////////////////////////////////////////////////
+// LogTail.cpp - Streams a running process's shared-memory log ring    //
+// ver 1.1                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Attaches to the ring a process publishes with SharedRingSink and
+   writes its records to std::cout as they arrive.  With --grep, writes
+   only records containing text, one per line.  The match runs on the
+   shared memory in place, so only matching records are copied out,
+   and each is checked against its slot's sequence before it is
+   written.  Records the writer overwrote before LogTail read them
+   are reported as a gap, and reading resumes with newer records.
+   Exits when the writer closes its sink or its process ends.
+
+   usage: LogTail [--from-start] [--grep text] <pid or ring name>
+
+   Dependencies:
+  ---------------
+   SharedRing.h, SharedRing.cpp
+   LogSinks.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.1 : 16 Oct 2026
+   - writes records only after the reader validates them
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include "../SharedRing/SharedRing.h"
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <chrono>
+#include <cctype>
+
+int main(int argc, char* argv[]) {
+  bool fromStart = false;
+  std::string pattern;
+  std::string target;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--from-start")
+      fromStart = true;
+    else if (arg == "--grep" && i + 1 < argc)
+      pattern = argv[++i];
+    else
+      target = arg;
+  }
+  if (target.empty()) {
+    std::cout << "\n  usage: LogTail [--from-start] [--grep text] <pid or ring name>\n";
+    return 1;
+  }
+  bool isPid = target.find_first_not_of("0123456789") == std::string::npos;
+  std::string name = isPid ? Test::sharedRingName(static_cast<uint32_t>(std::stoul(target))) : target;
+
+  Test::SharedRingReader reader;
+  if (!reader.attach(name, fromStart)) {
+    std::cout << "\n  can't attach to ring \"" << name << "\"\n";
+    return 1;
+  }
+  std::cerr << "\n  attached to " << name << ", process " << reader.pid() << "\n";
+
+  auto accept = [&pattern](std::string_view text) {
+    return pattern.empty() || text.find(pattern) != std::string_view::npos;
+  };
+  auto onRecord = [&pattern](const Test::SharedRingReader::Record& rec) {
+    if (rec.startsLine || !pattern.empty())
+      std::cout.put('\n');
+    std::cout.write(rec.text.data(), static_cast<std::streamsize>(rec.text.size()));
+  };
+  auto onGap = [](uint64_t count) {
+    std::cout << "\n  -- LogTail fell behind, " << count << " records lost --\n";
+  };
+
+  size_t idleMillisecs = 1;
+  while (true) {
+    size_t count = reader.pollMatching(accept, onRecord, onGap);
+    if (count > 0) {
+      std::cout.flush();
+      idleMillisecs = 1;
+      continue;
+    }
+    if (!reader.writerAlive() && !reader.pending())
+      break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(idleMillisecs));
+    if (idleMillisecs < 8)
+      idleMillisecs *= 2;
+  }
+  std::cout.flush();
+  std::cerr << "\n  writer finished, " << reader.lost() << " records lost\n";
+  return 0;
+}
@@ -0,0 +1,515 @@
+/////////////////////////////////////////////////////////////////////////
+// BenchSuite.cpp - Logger benchmark suite with CSV and JSON results   //
+// ver 1.2                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   LoggerBench's --suite mode.  Runs a matrix of logger benchmarks and
+   records every run, so results can be compared across releases:
+   - loggers:      TestLogger, QTestLogger (BlockingQueue), and
+                   RingQTestLogger (MpscRingBuffer)
+   - producers:    1, 2, 4, 8, 16 posting threads
+   - message size: 16, 64, 256, 1024, 4096 chars
+   - sinks:        1, 2, 4, 8 sinks on one logger
+   - sink type:    null     - discards output
+                   memory   - appends to a 16 MB buffer, wrapping
+                   file     - FdSink writing a temporary file
+                   cout     - std::cout through addStream, only with
+                              --cout, so redirect standard output
+   The default sweep varies one dimension at a time from a baseline of
+   1 producer, 128 char messages, and 1 null sink.  --full runs the
+   cross product of 1, 4, 16 producers, 16, 128, 1024 char messages,
+   1 and 4 sinks, and every sink type.
+
+   Each run reports:
+   - post() latency p50, p99, p99.9, max, and mean, in ns, timed on
+     the producer threads with std::chrono::steady_clock.  Timing adds
+     the cost of two clock reads to every sample.
+   - throughput in msgs/sec and MB/sec, from the first post until the
+     last message reaches every sink, i.e., after wait() for queued
+     loggers
+   - heap allocations and bytes allocated per message, counted by
+     LoggerBench's replaced global operator new over the timed posts.
+     A warm up pass runs first, so buffers and queues start at working
+     size.
+
+   Usage:
+     LoggerBench --suite [--messages N] [--csv file] [--json file] [--full] [--cout]
+   N is messages per run, a positive number, default 50000.  Results always print as a
+   table; --csv and --json also write them to files.
+
+   Build with optimization (Release configuration).
+
+   Dependencies:
+  ---------------
+   BenchSuite.h, LoggerBench.cpp
+   QTestLogger.h, TestLogger.h, ITestLogger.h, IQTestLogger.h, LogSinks.h
+   LogRecord.h, MessageBuilder.h
+   Cpp11-BlockingQueue.h, MpscRingBuffer.h
+   DateTime.h, DateTime.cpp, TimestampFormatter.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.2 : 16 Oct 2026
+   - --messages is checked, printing usage for anything but a
+     positive number
+   ver 1.1 : 16 Oct 2026
+   - moved from its own project into LoggerBench, as its --suite mode,
+     sharing LoggerBench's allocation counters
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include "BenchSuite.h"
+#include "../TestLogger/TestLogger.h"
+#include "../TestLogger/QTestLogger.h"
+#include "../DateTime/TimestampFormatter.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <set>
+#include <tuple>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <charconv>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <type_traits>
+
+namespace {
+
+  using Clock = std::chrono::steady_clock;
+  using namespace Test;
+
+  /////////////////////////////////////////////////////////
+  // benchmark sinks
+
+  /*-- discards output --*/
+  class NullSink : public ISink {
+  public:
+    virtual bool write(std::string_view) override { return true; }
+    virtual void flush() override {}
+    virtual void close() override {}
+  };
+
+  /*-- appends to a fixed size buffer, starting over when full --*/
+  class WrappingMemorySink : public ISink {
+  public:
+    static constexpr size_t capacity = 16 * 1024 * 1024;
+    WrappingMemorySink() {
+      buffer_.reserve(capacity);
+    }
+    virtual bool write(std::string_view data) override {
+      if (buffer_.size() + data.size() > capacity)
+        buffer_.clear();
+      if (data.size() <= capacity)
+        buffer_.append(data.data(), data.size());
+      return true;
+    }
+    virtual void flush() override {}
+    virtual void close() override {}
+  private:
+    std::string buffer_;
+  };
+
+  enum class SinkType { null, memory, file, cout };
+
+  const char* sinkName(SinkType t) {
+    switch (t) {
+    case SinkType::null:   return "null";
+    case SinkType::memory: return "memory";
+    case SinkType::file:   return "file";
+    default:               return "cout";
+    }
+  }
+
+  enum class LoggerType { sync, queued, ring };
+
+  const char* loggerName(LoggerType t) {
+    switch (t) {
+    case LoggerType::sync:   return "TestLogger";
+    case LoggerType::queued: return "QTestLogger";
+    default:                 return "RingQTestLogger";
+    }
+  }
+
+  const char* queueName(LoggerType t) {
+    switch (t) {
+    case LoggerType::sync:   return "none";
+    case LoggerType::queued: return "BlockingQueue";
+    default:                 return "MpscRingBuffer";
+    }
+  }
+
+  struct Config {
+    LoggerType logger = LoggerType::sync;
+    size_t producers = 1;
+    size_t msgSize = 128;
+    size_t sinks = 1;
+    SinkType sinkType = SinkType::null;
+
+    auto key() const { return std::make_tuple(logger, producers, msgSize, sinks, sinkType); }
+    bool operator<(const Config& c) const { return key() < c.key(); }
+  };
+
+  struct Result {
+    Config config;
+    size_t messages = 0;
+    double p50Ns = 0.0;
+    double p99Ns = 0.0;
+    double p999Ns = 0.0;
+    double maxNs = 0.0;
+    double meanNs = 0.0;
+    double msgsPerSec = 0.0;
+    double mbPerSec = 0.0;
+    double allocsPerMsg = 0.0;
+    double allocBytesPerMsg = 0.0;
+  };
+
+  /*-- sorted sample at fraction q of the way through --*/
+  double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty())
+      return 0.0;
+    size_t idx = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+    return sorted[idx];
+  }
+
+  /*-----------------------------------------------------
+    run one configuration on logger type Logger
+    - totalMsgs is split evenly across producers
+    - file sinks write bench_suite_N.log, removed after
+  */
+  template<typename Logger>
+  Result runConfig(const Config& cfg, size_t totalMsgs) {
+    constexpr bool queued = std::is_base_of_v<IQTestLogger<Level::all>, Logger>;
+    std::vector<std::unique_ptr<ISink>> sinks;
+    std::vector<std::string> files;
+    Logger logger;
+    for (size_t i = 0; i < cfg.sinks; ++i) {
+      if (cfg.sinkType == SinkType::cout) {
+        logger.addStream(&std::cout);
+        continue;
+      }
+      if (cfg.sinkType == SinkType::null)
+        sinks.push_back(std::make_unique<NullSink>());
+      else if (cfg.sinkType == SinkType::memory)
+        sinks.push_back(std::make_unique<WrappingMemorySink>());
+      else {
+        files.push_back("bench_suite_" + std::to_string(i) + ".log");
+        sinks.push_back(std::make_unique<FdSink>(files.back()));
+      }
+      logger.addSink(sinks.back().get());
+    }
+
+    size_t perThread = totalMsgs / cfg.producers;
+    if (perThread == 0)
+      perThread = 1;
+    const std::string msg(cfg.msgSize, 'x');
+    std::vector<std::vector<double>> latencies(cfg.producers);
+    for (auto& lat : latencies)
+      lat.reserve(perThread);
+
+    /* warm up, untimed and uncounted */
+    size_t warmUp = std::min<size_t>(perThread, 10000);
+    for (size_t i = 0; i < warmUp; ++i)
+      logger.post(msg);
+    if constexpr (queued)
+      logger.wait();
+
+    /* producers start together, after thread creation's allocations */
+    std::vector<std::thread> threads;
+    threads.reserve(cfg.producers);
+    std::atomic<size_t> ready{ 0 };
+    std::atomic<bool> go{ false };
+    for (size_t p = 0; p < cfg.producers; ++p) {
+      threads.emplace_back([&, p]() {
+        std::vector<double>& lat = latencies[p];
+        ++ready;
+        while (!go.load())
+          std::this_thread::yield();
+        for (size_t i = 0; i < perThread; ++i) {
+          Clock::time_point t0 = Clock::now();
+          logger.post(msg);
+          Clock::time_point t1 = Clock::now();
+          lat.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+      });
+    }
+    while (ready.load() < cfg.producers)
+      std::this_thread::yield();
+    size_t allocsBefore = heapAllocations.load();
+    size_t bytesBefore = heapBytes.load();
+    Clock::time_point begin = Clock::now();
+    go.store(true);
+    for (auto& t : threads)
+      t.join();
+    if constexpr (queued)
+      logger.wait();
+    double secs = std::chrono::duration<double>(Clock::now() - begin).count();
+    size_t allocs = heapAllocations.load() - allocsBefore;
+    size_t bytes = heapBytes.load() - bytesBefore;
+
+    logger.clear();
+    for (auto& pSink : sinks)
+      pSink->close();
+    for (auto& file : files)
+      std::remove(file.c_str());
+
+    std::vector<double> all;
+    all.reserve(perThread * cfg.producers);
+    for (auto& lat : latencies)
+      all.insert(all.end(), lat.begin(), lat.end());
+    std::sort(all.begin(), all.end());
+    double sum = 0.0;
+    for (double d : all)
+      sum += d;
+
+    Result r;
+    r.config = cfg;
+    r.messages = all.size();
+    r.p50Ns = percentile(all, 0.50);
+    r.p99Ns = percentile(all, 0.99);
+    r.p999Ns = percentile(all, 0.999);
+    r.maxNs = all.back();
+    r.meanNs = sum / all.size();
+    r.msgsPerSec = all.size() / secs;
+    size_t lineSize = cfg.msgSize + 3;  // default prefix "\n  "
+    r.mbPerSec = r.msgsPerSec * lineSize * cfg.sinks / (1024.0 * 1024.0);
+    r.allocsPerMsg = static_cast<double>(allocs) / all.size();
+    r.allocBytesPerMsg = static_cast<double>(bytes) / all.size();
+    return r;
+  }
+
+  Result run(const Config& cfg, size_t totalMsgs) {
+    switch (cfg.logger) {
+    case LoggerType::sync:
+      return runConfig<TestLogger<Level::all>>(cfg, totalMsgs);
+    case LoggerType::queued:
+      return runConfig<QTestLogger<Level::all>>(cfg, totalMsgs);
+    default:
+      return runConfig<RingQTestLogger<Level::all>>(cfg, totalMsgs);
+    }
+  }
+
+  /*-- configurations to run, in run order, without duplicates --*/
+  std::vector<Config> makeConfigs(bool full, bool withCout) {
+    std::vector<SinkType> types{ SinkType::null, SinkType::memory, SinkType::file };
+    if (withCout)
+      types.push_back(SinkType::cout);
+    std::vector<Config> configs;
+    std::set<Config> seen;
+    auto addConfig = [&](const Config& c) {
+      if (seen.insert(c).second)
+        configs.push_back(c);
+    };
+    for (LoggerType lt : { LoggerType::sync, LoggerType::queued, LoggerType::ring }) {
+      Config base;
+      base.logger = lt;
+      if (full) {
+        for (size_t producers : { 1, 4, 16 })
+          for (size_t msgSize : { 16, 128, 1024 })
+            for (size_t sinks : { 1, 4 })
+              for (SinkType st : types) {
+                Config c = base;
+                c.producers = producers;
+                c.msgSize = msgSize;
+                c.sinks = sinks;
+                c.sinkType = st;
+                addConfig(c);
+              }
+        continue;
+      }
+      for (size_t producers : { 1, 2, 4, 8, 16 }) {
+        Config c = base;
+        c.producers = producers;
+        addConfig(c);
+      }
+      for (size_t msgSize : { 16, 64, 256, 1024, 4096 }) {
+        Config c = base;
+        c.msgSize = msgSize;
+        addConfig(c);
+      }
+      for (size_t sinks : { 1, 2, 4, 8 }) {
+        Config c = base;
+        c.sinks = sinks;
+        addConfig(c);
+      }
+      for (SinkType st : types) {
+        Config c = base;
+        c.sinkType = st;
+        addConfig(c);
+      }
+    }
+    return configs;
+  }
+
+  /////////////////////////////////////////////////////////
+  // result output
+
+  void showHeader() {
+    std::cout << "\n  " << std::left << std::setw(16) << "logger"
+      << std::right << std::setw(5) << "thrd" << std::setw(6) << "size"
+      << std::setw(6) << "sinks" << std::setw(8) << "type"
+      << std::setw(9) << "p50 ns" << std::setw(9) << "p99 ns" << std::setw(10) << "p99.9 ns"
+      << std::setw(12) << "msgs/sec" << std::setw(9) << "allocs";
+    std::cout << "\n  " << std::string(90, '-');
+  }
+
+  void showRow(const Result& r) {
+    const Config& c = r.config;
+    std::cout << "\n  " << std::left << std::setw(16) << loggerName(c.logger)
+      << std::right << std::setw(5) << c.producers << std::setw(6) << c.msgSize
+      << std::setw(6) << c.sinks << std::setw(8) << sinkName(c.sinkType)
+      << std::fixed << std::setprecision(0)
+      << std::setw(9) << r.p50Ns << std::setw(9) << r.p99Ns << std::setw(10) << r.p999Ns
+      << std::setw(12) << r.msgsPerSec
+      << std::setw(9) << std::setprecision(3) << r.allocsPerMsg;
+  }
+
+  /*-- one line per run, first line names the columns --*/
+  bool writeCsv(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    if (!out.good())
+      return false;
+    out << "logger,queue,producers,msg_bytes,sinks,sink_type,messages,"
+      << "p50_ns,p99_ns,p999_ns,max_ns,mean_ns,msgs_per_sec,mb_per_sec,"
+      << "allocs_per_msg,alloc_bytes_per_msg\n";
+    out << std::fixed;
+    for (auto& r : results) {
+      const Config& c = r.config;
+      out << loggerName(c.logger) << ',' << queueName(c.logger) << ','
+        << c.producers << ',' << c.msgSize << ',' << c.sinks << ','
+        << sinkName(c.sinkType) << ',' << r.messages << ','
+        << std::setprecision(1)
+        << r.p50Ns << ',' << r.p99Ns << ',' << r.p999Ns << ','
+        << r.maxNs << ',' << r.meanNs << ','
+        << std::setprecision(0) << r.msgsPerSec << ','
+        << std::setprecision(2) << r.mbPerSec << ','
+        << std::setprecision(4) << r.allocsPerMsg << ',' << r.allocBytesPerMsg << '\n';
+    }
+    return out.good();
+  }
+
+  /*-- suite description and an array of run objects --*/
+  bool writeJson(
+    const std::string& path, const std::vector<Result>& results,
+    size_t totalMsgs, bool full
+  ) {
+    std::ofstream out(path);
+    if (!out.good())
+      return false;
+    Utilities::TimestampFormatter formatter;
+    char stamp[Utilities::TimestampFormatter::bufferSize];
+    size_t len = formatter.format(
+      stamp, sizeof(stamp), Utilities::TimestampFormatter::Precision::micro,
+      Utilities::TimestampFormatter::Zone::utc
+    );
+    out << "{\n  \"suite\": \"BenchSuite\",\n  \"version\": \"1.0\",\n"
+      << "  \"date\": \"" << std::string(stamp, len) << "\",\n"
+      << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+      << "  \"messages_per_run\": " << totalMsgs << ",\n"
+      << "  \"sweep\": \"" << (full ? "full" : "one-at-a-time") << "\",\n"
+      << "  \"results\": [";
+    out << std::fixed;
+    for (size_t i = 0; i < results.size(); ++i) {
+      const Result& r = results[i];
+      const Config& c = r.config;
+      out << (i == 0 ? "\n" : ",\n")
+        << "    { \"logger\": \"" << loggerName(c.logger) << "\""
+        << ", \"queue\": \"" << queueName(c.logger) << "\""
+        << ", \"producers\": " << c.producers
+        << ", \"msg_bytes\": " << c.msgSize
+        << ", \"sinks\": " << c.sinks
+        << ", \"sink_type\": \"" << sinkName(c.sinkType) << "\""
+        << ", \"messages\": " << r.messages
+        << std::setprecision(1)
+        << ", \"p50_ns\": " << r.p50Ns
+        << ", \"p99_ns\": " << r.p99Ns
+        << ", \"p999_ns\": " << r.p999Ns
+        << ", \"max_ns\": " << r.maxNs
+        << ", \"mean_ns\": " << r.meanNs
+        << std::setprecision(0)
+        << ", \"msgs_per_sec\": " << r.msgsPerSec
+        << std::setprecision(2)
+        << ", \"mb_per_sec\": " << r.mbPerSec
+        << std::setprecision(4)
+        << ", \"allocs_per_msg\": " << r.allocsPerMsg
+        << ", \"alloc_bytes_per_msg\": " << r.allocBytesPerMsg << " }";
+    }
+    out << "\n  ]\n}\n";
+    return out.good();
+  }
+}
+
+/*-- parse a positive decimal count, false if text is anything else --*/
+bool parseCount(const char* text, size_t& count) {
+  const char* end = text + std::strlen(text);
+  size_t value = 0;
+  auto res = std::from_chars(text, end, value);
+  if (res.ec != std::errc() || res.ptr != end || value == 0)
+    return false;
+  count = value;
+  return true;
+}
+
+/*-- run suite, argv[0] is "--suite", options follow --*/
+int runBenchSuite(int argc, char* argv[]) {
+
+  size_t totalMsgs = 50000;
+  std::string csvPath, jsonPath;
+  bool full = false;
+  bool withCout = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--messages" && i + 1 < argc && parseCount(argv[i + 1], totalMsgs))
+      ++i;
+    else if (arg == "--csv" && i + 1 < argc)
+      csvPath = argv[++i];
+    else if (arg == "--json" && i + 1 < argc)
+      jsonPath = argv[++i];
+    else if (arg == "--full")
+      full = true;
+    else if (arg == "--cout")
+      withCout = true;
+    else {
+      std::cout << "\n  usage: LoggerBench --suite [--messages N] [--csv file] [--json file] [--full] [--cout]\n\n";
+      return 1;
+    }
+  }
+
+  std::vector<Config> configs = makeConfigs(full, withCout);
+  std::vector<Result> results;
+  results.reserve(configs.size());
+  for (auto& cfg : configs)
+    results.push_back(run(cfg, totalMsgs));
+
+  std::cout << makeTitle("Logger benchmark suite");
+  std::cout << "\n  " << configs.size() << " runs, " << totalMsgs << " messages per run";
+  std::cout << "\n";
+  showHeader();
+  for (auto& r : results)
+    showRow(r);
+  std::cout << "\n";
+
+  if (!csvPath.empty()) {
+    if (writeCsv(csvPath, results))
+      std::cout << "\n  wrote " << csvPath;
+    else
+      std::cout << "\n  can't write " << csvPath;
+  }
+  if (!jsonPath.empty()) {
+    if (writeJson(jsonPath, results, totalMsgs, full))
+      std::cout << "\n  wrote " << jsonPath;
+    else
+      std::cout << "\n  can't write " << jsonPath;
+  }
+  std::cout << "\n\n";
+  return 0;
+}
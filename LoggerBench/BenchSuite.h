@@ -0,0 +1,37 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// BenchSuite.h - LoggerBench's benchmark matrix mode                  //
+// ver 1.1                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Declares what LoggerBench.cpp and BenchSuite.cpp share:
+   - heapAllocations and heapBytes, counted by LoggerBench's replaced
+     global operator new
+   - runBenchSuite, run by LoggerBench --suite, see BenchSuite.cpp
+   - parseCount, checking message count arguments
+
+   Dependencies:
+  ---------------
+   BenchSuite.cpp, LoggerBench.cpp
+
+   Maintenance History:
+  ----------------------
+   ver 1.1 : 16 Oct 2026
+   - added parseCount
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <atomic>
+#include <cstddef>
+
+extern std::atomic<size_t> heapAllocations;
+extern std::atomic<size_t> heapBytes;
+
+int runBenchSuite(int argc, char* argv[]);
+
+/*-- parse a positive decimal count, false if text is anything else --*/
+bool parseCount(const char* text, size_t& count);
@@ -0,0 +1,552 @@
+/////////////////////////////////////////////////////////////////////////
+// LoggerBench.cpp - Measures post latency and throughput of loggers   //
+// ver 2.2                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Compares QTestLogger post queue policies:
+   - QTestLogger<Level::all>      uses BlockingQueue<QRecord>
+   - RingQTestLogger<Level::all>  uses MpscRingBuffer<QRecord>
+   For 1, 4, 16, and 64 producer threads, reports:
+   - mean and p99 post() latency, measured on the producer threads
+   - throughput, from first post until wait() sees an empty queue
+   Messages go to a null stream so the write thread's sink cost
+   doesn't hide queue cost.
+
+   Also compares write thread batch sizes, reporting throughput and
+   sink writes per message.  The null sink is unbuffered, so each sink
+   write stands for one write syscall on an unbuffered file.
+
+   Also measures the post() + wait() round trip, which test suites
+   pay every time they wait for output to reach its streams.
+
+   Also measures contention on the synchronous TestLogger: 1 to 8
+   threads posting through one logger to two null streams.
+
+   Also compares producer-side cost of a formatted post, built with
+   std::to_string and operator+, against a deferred post of the same
+   arguments, both on RingQTestLogger.
+
+   Also compares DateTime::now() with TimestampFormatter, the source
+   of postDated timestamps.
+
+   Also compares TestLogger writing through std::ostream, via its
+   OStreamSink adapter, with writing to a native ISink, both discarding
+   output, to show iostream overhead per write.
+
+   Also compares file sinks, std::filebuf and MappedFileStream, with
+   RingQTestLogger posting to a real file.  Reports MB/sec from first
+   post until the sink is closed.  MappedFileStream is expected to be
+   the slower one, it pays a page fault per page written, see
+   MappedFileStream.h.
+
+   Also counts heap allocations per post, with global operator new
+   replaced by a counting version.  Each logger first runs a warm up
+   pass, so buffers, queue storage, and SpillPool reach their working
+   sizes, then the count covers a second pass of the same posts.
+   Queued loggers post in bursts of 256 followed by wait().
+
+   Also compares building a message of numbers and text with
+   std::to_string and operator+ against MessageBuilder, posting each
+   to TestLogger with a native null sink, in ns and allocations per
+   post.
+
+   LoggerBench --suite runs the benchmark matrix instead, writing CSV
+   and JSON results, see BenchSuite.cpp.
+
+   Usage:
+     LoggerBench [messages]
+   messages is a positive number, default 256000.
+     LoggerBench --suite [--messages N] [--csv file] [--json file] [--full] [--cout]
+
+   Build with optimization (Release configuration).
+
+   Dependencies:
+  ---------------
+   BenchSuite.h, BenchSuite.cpp
+   QTestLogger.h, TestLogger.h, ITestLogger.h, IQTestLogger.h, LogSinks.h
+   LogRecord.h, MessageBuilder.h
+   Cpp11-BlockingQueue.h, MpscRingBuffer.h
+   DateTime.h, DateTime.cpp
+   MappedFileStream.h, MappedFileStream.cpp
+
+   Maintenance History:
+  ----------------------
+   ver 2.2 : 16 Oct 2026
+   - messages argument is checked, printing usage for anything but a
+     positive number
+   ver 2.1 : 16 Oct 2026
+   - file sink comparison documents MappedFileStream as the slower sink
+   ver 2.0 : 16 Oct 2026
+   - added --suite mode, the benchmark matrix formerly in BenchSuite,
+     and heapBytes, counted with heapAllocations
+   ver 1.9 : 16 Oct 2026
+   - added MessageBuilder measurement
+   ver 1.8 : 16 Oct 2026
+   - added heap allocations per post measurement
+   ver 1.7 : 16 Oct 2026
+   - added ostream versus native sink measurement
+   ver 1.6 : 16 Oct 2026
+   - added file sink comparison
+   ver 1.5 : 16 Oct 2026
+   - added timestamp formatting measurement
+   ver 1.4 : 16 Oct 2026
+   - added deferred post measurement
+   ver 1.3 : 16 Oct 2026
+   - added TestLogger contention measurement
+   ver 1.2 : 16 Oct 2026
+   - added post + wait round trip measurement
+   ver 1.1 : 16 Oct 2026
+   - added write thread batching comparison
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include "BenchSuite.h"
+#include "../TestLogger/TestLogger.h"
+#include "../TestLogger/QTestLogger.h"
+#include "../DateTime/TimestampFormatter.h"
+#include "../MappedFile/MappedFileStream.h"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <iomanip>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+/////////////////////////////////////////////////////////////////////
+// counting global allocator, see runAllocs and BenchSuite.cpp
+
+std::atomic<size_t> heapAllocations{ 0 };
+std::atomic<size_t> heapBytes{ 0 };
+
+void* operator new(std::size_t size) {
+  heapAllocations.fetch_add(1, std::memory_order_relaxed);
+  heapBytes.fetch_add(size, std::memory_order_relaxed);
+  void* p = std::malloc(size > 0 ? size : 1);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+void operator delete[](void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+  using Clock = std::chrono::steady_clock;
+
+  /*-- stream buffer that discards output, counting write calls --*/
+  class NullBuf : public std::streambuf {
+  public:
+    size_t writes() { return writes_; }
+  protected:
+    int overflow(int c) override { ++writes_; return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { ++writes_; return n; }
+  private:
+    size_t writes_ = 0;
+  };
+
+  /*-- native sink that discards output, counting write calls --*/
+  class NullSink : public Test::ISink {
+  public:
+    size_t writes() { return writes_; }
+    virtual bool write(std::string_view) override { ++writes_; return true; }
+    virtual void flush() override {}
+    virtual void close() override {}
+  private:
+    size_t writes_ = 0;
+  };
+
+  struct Result {
+    double meanNs = 0.0;
+    double p99Ns = 0.0;
+    double msgsPerSec = 0.0;
+    double writesPerMsg = 0.0;
+  };
+
+  /*-- post totalMsgs messages from producers threads, time each post --*/
+  template<typename Logger>
+  Result runPosts(size_t producers, size_t totalMsgs, size_t maxBatch = 256) {
+    NullBuf nullBuf;
+    std::ostream nullStrm(&nullBuf);
+    Logger logger;
+    logger.addStream(&nullStrm);
+    logger.setPrefix("\n  ");
+    logger.setBatching(maxBatch);
+
+    size_t perThread = totalMsgs / producers;
+    std::vector<std::vector<double>> latencies(producers);
+    std::vector<std::thread> threads;
+    const std::string msg(48, 'x');
+
+    Clock::time_point begin = Clock::now();
+    for (size_t p = 0; p < producers; ++p) {
+      threads.emplace_back([&, p]() {
+        std::vector<double>& lat = latencies[p];
+        lat.reserve(perThread);
+        for (size_t i = 0; i < perThread; ++i) {
+          Clock::time_point t0 = Clock::now();
+          logger.post(msg);
+          Clock::time_point t1 = Clock::now();
+          lat.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+      });
+    }
+    for (auto& t : threads)
+      t.join();
+    logger.wait();
+    double secs = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    std::vector<double> all;
+    all.reserve(perThread * producers);
+    for (auto& lat : latencies)
+      all.insert(all.end(), lat.begin(), lat.end());
+    Result r;
+    double sum = 0.0;
+    for (double d : all)
+      sum += d;
+    r.meanNs = sum / all.size();
+    size_t idx99 = static_cast<size_t>(0.99 * (all.size() - 1));
+    std::nth_element(all.begin(), all.begin() + idx99, all.end());
+    r.p99Ns = all[idx99];
+    r.msgsPerSec = all.size() / secs;
+    r.writesPerMsg = static_cast<double>(nullBuf.writes()) / all.size();
+    logger.clear();
+    return r;
+  }
+
+  /*-- mean microseconds for one post followed by wait() --*/
+  template<typename Logger>
+  double runPostWait(size_t iterations) {
+    NullBuf nullBuf;
+    std::ostream nullStrm(&nullBuf);
+    Logger logger;
+    logger.addStream(&nullStrm);
+    Clock::time_point begin = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+      logger.post("round trip");
+      logger.wait();
+    }
+    double usecs = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+    logger.clear();
+    return usecs / iterations;
+  }
+
+  /*-- msgs/sec for threads posting concurrently through one TestLogger --*/
+  double runContention(size_t threadCount, size_t totalMsgs) {
+    NullBuf nullBuf1, nullBuf2;
+    std::ostream nullStrm1(&nullBuf1), nullStrm2(&nullBuf2);
+    Test::TestLogger<Test::Level::all> logger;
+    logger.addStream(&nullStrm1);
+    logger.addStream(&nullStrm2);
+    size_t perThread = totalMsgs / threadCount;
+    const std::string msg(48, 'x');
+    std::vector<std::thread> threads;
+    Clock::time_point begin = Clock::now();
+    for (size_t t = 0; t < threadCount; ++t) {
+      threads.emplace_back([&]() {
+        for (size_t i = 0; i < perThread; ++i)
+          logger.post(msg);
+      });
+    }
+    for (auto& t : threads)
+      t.join();
+    double secs = std::chrono::duration<double>(Clock::now() - begin).count();
+    logger.clear();
+    return perThread * threadCount / secs;
+  }
+
+  /*-- mean ns per TestLogger post to a discarding ostream or native sink --*/
+  template<bool native>
+  double runSinkPosts(size_t totalMsgs) {
+    NullBuf nullBuf;
+    std::ostream nullStrm(&nullBuf);
+    NullSink nullSink;
+    Test::TestLogger<Test::Level::all> logger;
+    if constexpr (native)
+      logger.addSink(&nullSink);
+    else
+      logger.addStream(&nullStrm);
+    const std::string msg(48, 'x');
+    Clock::time_point begin = Clock::now();
+    for (size_t i = 0; i < totalMsgs; ++i)
+      logger.post(msg);
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+    logger.clear();
+    return ns / totalMsgs;
+  }
+
+  /*-- mean producer ns per post, formatted on caller or deferred --*/
+  template<bool deferred>
+  double runDeferred(size_t totalMsgs) {
+    NullBuf nullBuf;
+    std::ostream nullStrm(&nullBuf);
+    Test::RingQTestLogger<Test::Level::all> logger;
+    logger.addStream(&nullStrm);
+    Clock::time_point begin = Clock::now();
+    for (size_t i = 0; i < totalMsgs; ++i) {
+      double ratio = i * 0.5;
+      if constexpr (deferred) {
+        TEST_POST_DEFERRED(logger, "iteration {} ratio {} state {}", i, ratio, "running");
+      }
+      else {
+        logger.post(
+          "iteration " + std::to_string(i) + " ratio " + std::to_string(ratio) + " state " + "running"
+        );
+      }
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+    logger.wait();
+    logger.clear();
+    return ns / totalMsgs;
+  }
+
+  /*-----------------------------------------------------
+    heap allocations per post, counted over a second pass
+    of totalMsgs posts of msgSize chars
+    - queued loggers wait() after every 256 posts
+  */
+  template<typename Logger>
+  double runAllocs(size_t totalMsgs, size_t msgSize, bool dated) {
+    constexpr bool queued = std::is_base_of_v<Test::IQTestLogger<Test::Level::all>, Logger>;
+    NullSink nullSink;
+    Logger logger;
+    logger.addSink(&nullSink);
+    const std::string msg(msgSize, 'x');
+    auto pass = [&]() {
+      for (size_t i = 0; i < totalMsgs; ++i) {
+        if (dated)
+          logger.postDated(msg);
+        else
+          logger.post(msg);
+        if constexpr (queued) {
+          if (i % 256 == 255)
+            logger.wait();
+        }
+      }
+      if constexpr (queued)
+        logger.wait();
+    };
+    pass();
+    size_t before = heapAllocations.load();
+    pass();
+    size_t count = heapAllocations.load() - before;
+    logger.clear();
+    return static_cast<double>(count) / totalMsgs;
+  }
+
+  struct BuildResult {
+    double nsPerPost = 0.0;
+    double allocsPerPost = 0.0;
+  };
+
+  /*-- build and post totalMsgs messages with operator+ or MessageBuilder --*/
+  template<bool builder>
+  BuildResult runBuild(size_t totalMsgs) {
+    NullSink nullSink;
+    Test::TestLogger<Test::Level::all> logger;
+    logger.addSink(&nullSink);
+    Test::MessageBuilder mb;
+    size_t before = heapAllocations.load();
+    Clock::time_point begin = Clock::now();
+    for (size_t i = 0; i < totalMsgs; ++i) {
+      double ratio = i * 0.5;
+      if constexpr (builder) {
+        mb.clear();
+        mb << "iteration " << i << " ratio " << ratio << " state " << "running";
+        logger.post(mb);
+      }
+      else {
+        logger.post(
+          "iteration " + std::to_string(i) + " ratio " + std::to_string(ratio) + " state " + "running"
+        );
+      }
+    }
+    BuildResult r;
+    r.nsPerPost = std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / totalMsgs;
+    r.allocsPerPost = static_cast<double>(heapAllocations.load() - before) / totalMsgs;
+    logger.clear();
+    return r;
+  }
+
+  /*-- mean ns to produce one timestamp string --*/
+  template<typename F>
+  double runTimestamps(size_t count, F f) {
+    Clock::time_point begin = Clock::now();
+    for (size_t i = 0; i < count; ++i)
+      f();
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / count;
+  }
+
+  /*-- std::filebuf stream, which TestLogger doesn't announce closing --*/
+  class FileStream : public std::ostream {
+  public:
+    FileStream(const std::string& path) : std::ostream(&buf_) {
+      buf_.open(path, std::ios::out | std::ios::binary);
+    }
+  private:
+    std::filebuf buf_;
+  };
+
+  /*-- MB/sec posting totalMsgs 128 byte lines to a file stream --*/
+  template<typename Stream>
+  double runFileSink(size_t totalMsgs, const std::string& path) {
+    const std::string msg(126, 'x');
+    Clock::time_point begin = Clock::now();
+    {
+      Stream file(path);
+      Test::RingQTestLogger<Test::Level::all> logger;
+      logger.addStream(&file);
+      logger.setPrefix("\n ");
+      for (size_t i = 0; i < totalMsgs; ++i)
+        logger.post(msg);
+      logger.wait();
+      logger.clear();
+    }
+    double secs = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::remove(path.c_str());
+    return totalMsgs * 128.0 / (1024.0 * 1024.0) / secs;
+  }
+
+  void showRow(const std::string& name, size_t producers, const Result& r) {
+    std::cout << "\n  " << std::left << std::setw(18) << name
+      << std::right << std::setw(6) << producers
+      << std::setw(12) << std::fixed << std::setprecision(1) << r.meanNs
+      << std::setw(12) << r.p99Ns
+      << std::setw(14) << std::setprecision(0) << r.msgsPerSec;
+  }
+}
+
+int main(int argc, char* argv[]) {
+
+  using namespace Test;
+
+  if (argc > 1 && std::string(argv[1]) == "--suite")
+    return runBenchSuite(argc - 1, argv + 1);
+
+  size_t totalMsgs = 256000;
+  if (argc > 2 || (argc > 1 && !parseCount(argv[1], totalMsgs))) {
+    std::cout << "\n  usage: LoggerBench [messages]"
+      << "\n         LoggerBench --suite [--messages N] [--csv file] [--json file] [--full] [--cout]\n\n";
+    return 1;
+  }
+
+  std::cout << makeTitle("Logger post queue benchmark");
+  std::cout << "\n  " << totalMsgs << " messages per run, null sink";
+  std::cout << "\n\n  " << std::left << std::setw(18) << "queue"
+    << std::right << std::setw(6) << "thrds"
+    << std::setw(12) << "mean ns" << std::setw(12) << "p99 ns"
+    << std::setw(14) << "msgs/sec";
+  std::cout << "\n  " << std::string(62, '-');
+
+  for (size_t producers : { 1, 4, 16, 64 }) {
+    showRow("BlockingQueue", producers,
+      runPosts<QTestLogger<Level::all>>(producers, totalMsgs));
+    showRow("MpscRingBuffer", producers,
+      runPosts<RingQTestLogger<Level::all>>(producers, totalMsgs));
+  }
+
+  std::cout << "\n" << maketitle("Write thread batching, BlockingQueue");
+  std::cout << "\n  " << std::left << std::setw(10) << "maxBatch"
+    << std::right << std::setw(6) << "thrds"
+    << std::setw(14) << "msgs/sec" << std::setw(14) << "writes/msg";
+  std::cout << "\n  " << std::string(44, '-');
+  for (size_t producers : { 1, 4 }) {
+    for (size_t maxBatch : { 1, 16, 256, 4096 }) {
+      Result r = runPosts<QTestLogger<Level::all>>(producers, totalMsgs, maxBatch);
+      std::cout << "\n  " << std::left << std::setw(10) << maxBatch
+        << std::right << std::setw(6) << producers
+        << std::setw(14) << std::fixed << std::setprecision(0) << r.msgsPerSec
+        << std::setw(14) << std::setprecision(4) << r.writesPerMsg;
+    }
+  }
+
+  std::cout << "\n" << maketitle("post + wait() round trip");
+  std::cout << "\n  BlockingQueue   " << std::setw(10) << std::setprecision(2)
+    << runPostWait<QTestLogger<Level::all>>(1000) << " usec";
+  std::cout << "\n  MpscRingBuffer  " << std::setw(10) << std::setprecision(2)
+    << runPostWait<RingQTestLogger<Level::all>>(1000) << " usec";
+
+  std::cout << "\n" << maketitle("TestLogger contention, two null streams");
+  for (size_t threadCount : { 1, 2, 4, 8 }) {
+    std::cout << "\n  " << std::setw(2) << threadCount << " threads "
+      << std::setw(14) << std::setprecision(0) << runContention(threadCount, totalMsgs)
+      << " msgs/sec";
+  }
+
+  std::cout << "\n" << maketitle("TestLogger post, std::ostream vs native sink");
+  std::cout << "\n  std::ostream    " << std::setw(10) << std::setprecision(1)
+    << runSinkPosts<false>(totalMsgs) << " ns/post";
+  std::cout << "\n  ISink           " << std::setw(10) << std::setprecision(1)
+    << runSinkPosts<true>(totalMsgs) << " ns/post";
+
+  std::cout << "\n" << maketitle("heap allocations per post, steady state");
+  std::cout << "\n  TestLogger post            " << std::setw(8) << std::setprecision(3)
+    << runAllocs<TestLogger<Level::all>>(totalMsgs, 48, false);
+  std::cout << "\n  TestLogger postDated       " << std::setw(8) << std::setprecision(3)
+    << runAllocs<TestLogger<Level::all>>(totalMsgs, 48, true);
+  std::cout << "\n  QTestLogger post           " << std::setw(8) << std::setprecision(3)
+    << runAllocs<QTestLogger<Level::all>>(totalMsgs, 48, false);
+  std::cout << "\n  QTestLogger postDated      " << std::setw(8) << std::setprecision(3)
+    << runAllocs<QTestLogger<Level::all>>(totalMsgs, 48, true);
+  std::cout << "\n  RingQTestLogger post       " << std::setw(8) << std::setprecision(3)
+    << runAllocs<RingQTestLogger<Level::all>>(totalMsgs, 48, false);
+  std::cout << "\n  QTestLogger post, 1 KB     " << std::setw(8) << std::setprecision(3)
+    << runAllocs<QTestLogger<Level::all>>(totalMsgs, 1024, false);
+
+  std::cout << "\n" << maketitle("message building, operator+ vs MessageBuilder");
+  BuildResult plus = runBuild<false>(totalMsgs);
+  BuildResult built = runBuild<true>(totalMsgs);
+  std::cout << "\n  operator+       " << std::setw(10) << std::setprecision(1)
+    << plus.nsPerPost << " ns/post" << std::setw(10) << std::setprecision(2)
+    << plus.allocsPerPost << " allocs/post";
+  std::cout << "\n  MessageBuilder  " << std::setw(10) << std::setprecision(1)
+    << built.nsPerPost << " ns/post" << std::setw(10) << std::setprecision(2)
+    << built.allocsPerPost << " allocs/post";
+
+  std::cout << "\n" << maketitle("producer cost, formatted vs deferred post");
+  std::cout << "\n  formatted post  " << std::setw(10) << std::setprecision(1)
+    << runDeferred<false>(totalMsgs) << " ns/post";
+  std::cout << "\n  deferred post   " << std::setw(10) << std::setprecision(1)
+    << runDeferred<true>(totalMsgs) << " ns/post";
+
+  std::cout << "\n" << maketitle("timestamp formatting");
+  Utilities::DateTime dt;
+  std::string dateStr;
+  std::cout << "\n  DateTime::now()       " << std::setw(10) << std::setprecision(1)
+    << runTimestamps(totalMsgs, [&]() { dateStr = dt.now(); }) << " ns";
+  Utilities::TimestampFormatter formatter;
+  char buffer[Utilities::TimestampFormatter::bufferSize];
+  std::cout << "\n  TimestampFormatter    " << std::setw(10) << std::setprecision(1)
+    << runTimestamps(totalMsgs, [&]() { formatter.format(buffer, sizeof(buffer)); }) << " ns";
+
+  std::cout << "\n" << maketitle("file sinks, RingQTestLogger, 128 byte lines");
+  std::cout << "\n  std::filebuf          " << std::setw(10) << std::setprecision(1)
+    << runFileSink<FileStream>(totalMsgs, "bench_ofstream.log") << " MB/sec";
+  std::cout << "\n  MappedFileStream      " << std::setw(10) << std::setprecision(1)
+    << runFileSink<MappedFileStream>(totalMsgs, "bench_mapped.log") << " MB/sec";
+  std::cout << "\n\n";
+}
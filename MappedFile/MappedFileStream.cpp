@@ -0,0 +1,211 @@
+/////////////////////////////////////////////////////////////////////////
+// MappedFileStream.cpp - std::ostream writing through a memory-mapped //
+//                        file                                         //
+// ver 1.1                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+
+#include "MappedFileStream.h"
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace Test;
+
+/*-- unmap and truncate file to bytes written --*/
+MappedFileBuf::~MappedFileBuf() {
+  close();
+}
+/*-----------------------------------------------------
+  create or truncate file and map its first segment
+  - segmentSize is rounded up to a multiple of 64 KB,
+    the Windows mapping granularity, which is also a
+    multiple of the POSIX page size
+*/
+bool MappedFileBuf::open(const std::string& path, size_t segmentSize) {
+  close();
+  const size_t granularity = 64 * 1024;
+  if (segmentSize < granularity)
+    segmentSize = granularity;
+  segmentSize_ = (segmentSize + granularity - 1) / granularity * granularity;
+  offset_.store(0, std::memory_order_release);
+#ifdef _WIN32
+  HANDLE h = CreateFileA(
+    path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+    CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr
+  );
+  if (h == INVALID_HANDLE_VALUE)
+    return false;
+  hFile_ = h;
+#else
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0)
+    return false;
+#endif
+  if (!mapSegment(0)) {
+    close();
+    return false;
+  }
+  return true;
+}
+/*-----------------------------------------------------
+  extend file to end of segment and map it
+  - preallocation reserves disk blocks up front, so
+    page faults on the mapping don't allocate
+  - pages are faulted in as they are first written.
+    MAP_POPULATE faulted the whole segment at map time,
+    then faulted each page again on its first write to
+    mark it dirty, and paid for the unused tail too
+*/
+bool MappedFileBuf::mapSegment(uint64_t segmentStart) {
+  uint64_t end = segmentStart + segmentSize_;
+#ifdef _WIN32
+  LARGE_INTEGER size;
+  size.QuadPart = static_cast<LONGLONG>(end);
+  if (!SetFilePointerEx(hFile_, size, nullptr, FILE_BEGIN) || !SetEndOfFile(hFile_))
+    return false;
+  HANDLE hMap = CreateFileMappingA(
+    hFile_, nullptr, PAGE_READWRITE,
+    static_cast<DWORD>(end >> 32), static_cast<DWORD>(end & 0xffffffff), nullptr
+  );
+  if (hMap == nullptr)
+    return false;
+  void* p = MapViewOfFile(
+    hMap, FILE_MAP_WRITE,
+    static_cast<DWORD>(segmentStart >> 32), static_cast<DWORD>(segmentStart & 0xffffffff),
+    segmentSize_
+  );
+  if (p == nullptr) {
+    CloseHandle(hMap);
+    return false;
+  }
+  hMapping_ = hMap;
+#else
+  int rc = ::posix_fallocate(fd_, static_cast<off_t>(segmentStart), static_cast<off_t>(segmentSize_));
+  if (rc != 0 && ::ftruncate(fd_, static_cast<off_t>(end)) != 0)
+    return false;
+  void* p = ::mmap(
+    nullptr, segmentSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, static_cast<off_t>(segmentStart)
+  );
+  if (p == MAP_FAILED)
+    return false;
+#endif
+  pBase_ = static_cast<char*>(p);
+  segmentStart_ = segmentStart;
+  segmentPos_ = 0;
+  return true;
+}
+/*-- release current segment's mapping --*/
+void MappedFileBuf::unmapSegment() {
+  if (pBase_ == nullptr)
+    return;
+#ifdef _WIN32
+  UnmapViewOfFile(pBase_);
+  CloseHandle(hMapping_);
+  hMapping_ = nullptr;
+#else
+  ::munmap(pBase_, segmentSize_);
+#endif
+  pBase_ = nullptr;
+}
+/*-- unmap, truncate preallocated tail, and close file --*/
+void MappedFileBuf::close() {
+  unmapSegment();
+  uint64_t length = offset_.load(std::memory_order_acquire);
+#ifdef _WIN32
+  if (hFile_ != nullptr) {
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(length);
+    SetFilePointerEx(hFile_, size, nullptr, FILE_BEGIN);
+    SetEndOfFile(hFile_);
+    CloseHandle(hFile_);
+    hFile_ = nullptr;
+  }
+#else
+  if (fd_ >= 0) {
+    if (::ftruncate(fd_, static_cast<off_t>(length)) != 0) {
+      // file keeps its preallocated zero tail
+    }
+    ::close(fd_);
+    fd_ = -1;
+  }
+#endif
+}
+/*-----------------------------------------------------
+  copy into mapping, moving to next segment when full
+  - returns count of bytes copied, less than count
+    only if the next segment can't be mapped
+*/
+std::streamsize MappedFileBuf::xsputn(const char* data, std::streamsize count) {
+  std::streamsize done = 0;
+  while (done < count && pBase_ != nullptr) {
+    size_t room = segmentSize_ - segmentPos_;
+    if (room == 0) {
+      uint64_t next = segmentStart_ + segmentSize_;
+      unmapSegment();
+      if (!mapSegment(next))
+        break;
+      room = segmentSize_;
+    }
+    size_t n = static_cast<size_t>(count - done);
+    if (n > room)
+      n = room;
+    std::memcpy(pBase_ + segmentPos_, data + done, n);
+    segmentPos_ += n;
+    done += static_cast<std::streamsize>(n);
+    offset_.store(segmentStart_ + segmentPos_, std::memory_order_release);
+  }
+  return done;
+}
+/*-- write one character --*/
+MappedFileBuf::int_type MappedFileBuf::overflow(int_type ch) {
+  if (traits_type::eq_int_type(ch, traits_type::eof()))
+    return traits_type::not_eof(ch);
+  char c = traits_type::to_char_type(ch);
+  return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+}
+
+#ifdef TEST_MAPPEDFILESTREAM
+
+#include <iostream>
+#include <fstream>
+
+int main()
+{
+  std::cout << "\n  Demonstrating MappedFileStream";
+  std::cout << "\n ================================";
+
+  const size_t lines = 10000;
+  {
+    MappedFileStream out("mapped.log", 64 * 1024);
+    std::cout << "\n  opened mapped.log: " << std::boolalpha << out.isOpen();
+    for (size_t i = 0; i < lines; ++i)
+      out << "line " << i << " of the mapped file demonstration\n";
+    std::cout << "\n  wrote " << out.bytesWritten() << " bytes through 64 KB segments";
+  }
+  std::ifstream in("mapped.log", std::ios::binary | std::ios::ate);
+  std::cout << "\n  file size after close = " << in.tellg();
+  in.seekg(0);
+  std::string line;
+  size_t count = 0;
+  bool ordered = true;
+  while (std::getline(in, line)) {
+    if (line != "line " + std::to_string(count) + " of the mapped file demonstration")
+      ordered = false;
+    ++count;
+  }
+  std::cout << "\n  read back " << count << " lines, all intact: " << (ordered && count == lines);
+  std::cout << "\n\n";
+}
+
+#endif
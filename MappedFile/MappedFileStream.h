@@ -0,0 +1,115 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// MappedFileStream.h - std::ostream writing through a memory-mapped   //
+//                      file                                           //
+// ver 1.1                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   MappedFileBuf is a std::streambuf that copies output directly into
+   a memory-mapped region of a file:
+   - the file is extended one segment at a time, preallocated with
+     posix_fallocate (SetEndOfFile on Windows), and that segment is
+     mapped into memory
+   - writes are memcpy's into the mapping; a full segment is unmapped
+     and the next one mapped
+   - there is no write() call per flush, the OS writes back dirty pages
+   - close() truncates the file to the bytes actually written
+   - bytesWritten() is an atomic offset, readable from any thread
+
+   It is not a faster file sink.  Every new page costs a page fault,
+   where std::filebuf's write() copies into the page cache without one,
+   so LoggerBench measures it below std::filebuf, by about 10% for
+   logger batches and up to half for large writes.  What it buys is
+   durability against a crash of the writing process: each byte is in
+   the page cache as soon as it is copied, with nothing left in a user
+   space buffer to lose.
+
+   MappedFileStream is a std::ostream owning a MappedFileBuf, so it can
+   be passed to TestLogger and QTestLogger addStream.  Writes must be
+   serialized, as the loggers' per-stream locks do.
+
+   Dependencies:
+  ---------------
+   MappedFileStream.h, MappedFileStream.cpp
+
+   Maintenance History:
+  ----------------------
+   ver 1.1 : 16 Oct 2026
+   - segments are no longer mapped with MAP_POPULATE, which faulted
+     every page twice, and the header no longer claims a speed up
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <streambuf>
+#include <ostream>
+#include <string>
+#include <atomic>
+#include <cstdint>
+
+namespace Test {
+
+  /////////////////////////////////////////////////////////
+  // MappedFileBuf
+
+  class MappedFileBuf : public std::streambuf {
+  public:
+    static constexpr size_t defaultSegmentSize = 64 * 1024 * 1024;
+
+    MappedFileBuf() {}
+    MappedFileBuf(const MappedFileBuf&) = delete;
+    MappedFileBuf& operator=(const MappedFileBuf&) = delete;
+    ~MappedFileBuf();
+    bool open(const std::string& path, size_t segmentSize = defaultSegmentSize);
+    bool isOpen() const { return pBase_ != nullptr; }
+    void close();
+    uint64_t bytesWritten() const { return offset_.load(std::memory_order_acquire); }
+  protected:
+    std::streamsize xsputn(const char* data, std::streamsize count) override;
+    int_type overflow(int_type ch) override;
+  private:
+    bool mapSegment(uint64_t segmentStart);
+    void unmapSegment();
+
+    char* pBase_ = nullptr;
+    uint64_t segmentStart_ = 0;
+    size_t segmentSize_ = 0;
+    size_t segmentPos_ = 0;
+    std::atomic<uint64_t> offset_{ 0 };
+#ifdef _WIN32
+    void* hFile_ = nullptr;
+    void* hMapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+  };
+
+  /////////////////////////////////////////////////////////
+  // MappedFileStream
+
+  class MappedFileStream : public std::ostream {
+  public:
+    MappedFileStream() : std::ostream(&buf_) {}
+    MappedFileStream(
+      const std::string& path, size_t segmentSize = MappedFileBuf::defaultSegmentSize
+    ) : std::ostream(&buf_) {
+      open(path, segmentSize);
+    }
+    bool open(const std::string& path, size_t segmentSize = MappedFileBuf::defaultSegmentSize) {
+      bool ok = buf_.open(path, segmentSize);
+      if (ok)
+        clear();
+      else
+        setstate(std::ios::failbit);
+      return ok;
+    }
+    bool isOpen() const { return buf_.isOpen(); }
+    void close() { buf_.close(); }
+    uint64_t bytesWritten() const { return buf_.bytesWritten(); }
+  private:
+    MappedFileBuf buf_;
+  };
+}
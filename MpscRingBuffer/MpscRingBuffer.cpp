@@ -0,0 +1,55 @@
+/////////////////////////////////////////////////////////////////////////
+// MpscRingBuffer.cpp - Bounded lock-free MPSC ring buffer             //
+// ver 1.0                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+
+#include "MpscRingBuffer.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef TEST_MPSCRINGBUFFER
+
+int main()
+{
+  std::cout << "\n  Demonstrating MpscRingBuffer";
+  std::cout << "\n ==============================";
+
+  MpscRingBuffer<std::string> q(16);
+  std::cout << "\n  capacity = " << q.capacity();
+
+  const size_t producers = 4;
+  const size_t perProducer = 1000;
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&q, p]() {
+      for (size_t i = 0; i < perProducer; ++i)
+        q.enQ("p" + std::to_string(p) + ":" + std::to_string(i));
+    });
+  }
+  std::vector<size_t> lastSeen(producers, 0);
+  size_t count = 0;
+  bool ordered = true;
+  while (count < producers * perProducer) {
+    std::string msg = q.deQ();
+    size_t colon = msg.find(':');
+    size_t p = std::stoul(msg.substr(1, colon - 1));
+    size_t i = std::stoul(msg.substr(colon + 1));
+    if (i != lastSeen[p])
+      ordered = false;
+    lastSeen[p] = i + 1;
+    ++count;
+  }
+  for (auto& t : threads)
+    t.join();
+  std::cout << "\n  deQed " << count << " messages from " << producers << " producers";
+  std::cout << "\n  per-producer order preserved: " << std::boolalpha << ordered;
+  std::cout << "\n  size after drain = " << q.size();
+
+  std::string msg;
+  std::cout << "\n  tryDeQ on empty buffer returns " << q.tryDeQ(msg);
+  std::cout << "\n\n";
+}
+
+#endif
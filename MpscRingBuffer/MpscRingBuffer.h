@@ -0,0 +1,329 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// MpscRingBuffer.h - Bounded lock-free multi-producer, single-consumer //
+//                    ring buffer                                      //
+// ver 1.3                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * This package contains one thread-safe class: MpscRingBuffer<T>.
+ * It is a drop-in replacement for BlockingQueue<T> when many threads
+ * enqueue and exactly one thread dequeues, e.g., the QTestLogger
+ * write thread.
+ *
+ * - Storage is a fixed array of slots, allocated once.  Capacity is
+ *   rounded up to a power of two.
+ * - Each slot carries a sequence number.  Producers claim a slot with
+ *   one compare-and-swap on the enqueue position, then publish it by
+ *   storing its sequence number.  No mutex is taken on enQ.
+ * - Enqueue and dequeue positions live on separate cache lines so
+ *   producers and the consumer don't false-share.
+ * - When the buffer is full enQ spins, then yields, until the consumer
+ *   frees a slot.  That is its only backpressure, there is no limit
+ *   on how long it waits.  tryEnQ returns 0 instead, so callers can
+ *   apply their own overflow policy, as QTestLogger does.
+ * - When the buffer is empty deQ spins briefly, then parks on a
+ *   condition variable until a producer notifies it.  Producers only
+ *   touch that condition variable when the consumer is parked, so the
+ *   common path is lock-free, and an idle consumer never wakes.
+ * - deQAll and tryDeQAll drain many elements in one call.  deQAllFor
+ *   waits like deQAll, but returns empty handed after a timeout.
+ * - enQ returns the element's ticket, its 1-based position in the
+ *   sequence of all elements ever enqueued.  The consumer always
+ *   dequeues in ticket order.
+ * - peekUnsafe(f) visits published, not yet dequeued elements from
+ *   any thread without blocking, for crash handlers.  Slots never
+ *   move, but an element may be dequeued while it is being read.
+ *
+ * Required Files:
+ * ---------------
+ * MpscRingBuffer.h, MpscRingBuffer.cpp (only for demonstration)
+ *
+ * Maintenance History:
+ * --------------------
+ * ver 1.3 : 16 Oct 2026
+ * - parked consumer waits until notified, not in 1 ms polls
+ * - added tryEnQ(T&&)
+ * ver 1.2 : 16 Oct 2026
+ * - added deQAllFor()
+ * ver 1.1 : 16 Oct 2026
+ * - added peekUnsafe()
+ * ver 1.0 : 16 Oct 2026
+ * - first release
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+template <typename T>
+class MpscRingBuffer {
+public:
+  static constexpr size_t cacheLine = 64;
+
+  explicit MpscRingBuffer(size_t capacity = 8192);
+  MpscRingBuffer(const MpscRingBuffer<T>&) = delete;
+  MpscRingBuffer<T>& operator=(const MpscRingBuffer<T>&) = delete;
+  T deQ();
+  size_t deQAll(std::vector<T>& batch, size_t maxCount = SIZE_MAX);
+  size_t deQAllFor(std::vector<T>& batch, size_t maxCount, std::chrono::microseconds timeout);
+  size_t tryDeQAll(std::vector<T>& batch, size_t maxCount = SIZE_MAX);
+  size_t enQ(const T& t);
+  size_t enQ(T&& t);
+  size_t tryEnQ(const T& t);
+  size_t tryEnQ(T&& t);
+  bool tryDeQ(T& t);
+  size_t size();
+  size_t enqueued() { return enqPos_.load(std::memory_order_acquire); }
+  size_t capacity() { return mask_ + 1; }
+  template<typename F>
+  size_t peekUnsafe(F f) const;
+private:
+  struct alignas(cacheLine) Slot {
+    std::atomic<size_t> seq;
+    T value;
+  };
+  template<typename U>
+  size_t tryPublish(U&& u);
+  bool ready() const;
+  void wake();
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_;
+  alignas(cacheLine) std::atomic<size_t> enqPos_{ 0 };
+  alignas(cacheLine) std::atomic<size_t> deqPos_{ 0 };
+  alignas(cacheLine) std::atomic<bool> parked_{ false };
+  std::mutex mtx_;
+  std::condition_variable cv_;
+};
+//----< construct with capacity rounded up to power of 2 >-------------
+
+template<typename T>
+MpscRingBuffer<T>::MpscRingBuffer(size_t capacity) {
+  size_t cap = 2;
+  while (cap < capacity)
+    cap <<= 1;
+  mask_ = cap - 1;
+  slots_.reset(new Slot[cap]);
+  for (size_t i = 0; i < cap; ++i)
+    slots_[i].seq.store(i, std::memory_order_relaxed);
+}
+//----< claim and fill next slot, returns ticket or 0 if full >-------
+/*
+ *  Slot sequence == pos means slot is free for the producer at pos.
+ *  Slot sequence == pos + 1 means slot holds data for the consumer.
+ */
+template<typename T>
+template<typename U>
+size_t MpscRingBuffer<T>::tryPublish(U&& u) {
+  size_t pos = enqPos_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = slots_[pos & mask_];
+    size_t seq = slot.seq.load(std::memory_order_acquire);
+    std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+    if (diff == 0) {
+      if (enqPos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        slot.value = std::forward<U>(u);
+        slot.seq.store(pos + 1, std::memory_order_release);
+        wake();
+        return pos + 1;
+      }
+    }
+    else if (diff < 0) {
+      return 0;
+    }
+    else {
+      pos = enqPos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+//----< notify consumer only if it has parked >------------------------
+
+template<typename T>
+void MpscRingBuffer<T>::wake() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (parked_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> l(mtx_);
+    cv_.notify_one();
+  }
+}
+//----< push element, waiting for space if full >----------------------
+
+template<typename T>
+size_t MpscRingBuffer<T>::enQ(const T& t) {
+  size_t spins = 0;
+  size_t ticket;
+  while ((ticket = tryPublish(t)) == 0) {
+    if (++spins < 64)
+      continue;
+    std::this_thread::yield();
+  }
+  return ticket;
+}
+//----< push element, waiting for space if full >----------------------
+
+template<typename T>
+size_t MpscRingBuffer<T>::enQ(T&& t) {
+  size_t spins = 0;
+  size_t ticket;
+  while ((ticket = tryPublish(std::move(t))) == 0) {
+    if (++spins < 64)
+      continue;
+    std::this_thread::yield();
+  }
+  return ticket;
+}
+//----< push element if there is space, returns ticket or 0 >---------
+
+template<typename T>
+size_t MpscRingBuffer<T>::tryEnQ(const T& t) {
+  return tryPublish(t);
+}
+//----< move element in if there is space, returns ticket or 0 >------
+/*
+ *  t is left unchanged when the buffer is full.
+ */
+template<typename T>
+size_t MpscRingBuffer<T>::tryEnQ(T&& t) {
+  return tryPublish(std::move(t));
+}
+//----< is an element published at the dequeue position >------------
+
+template<typename T>
+bool MpscRingBuffer<T>::ready() const {
+  size_t pos = deqPos_.load(std::memory_order_relaxed);
+  return slots_[pos & mask_].seq.load(std::memory_order_acquire) == pos + 1;
+}
+//----< pop element if available - consumer thread only >-------------
+
+template<typename T>
+bool MpscRingBuffer<T>::tryDeQ(T& t) {
+  size_t pos = deqPos_.load(std::memory_order_relaxed);
+  Slot& slot = slots_[pos & mask_];
+  if (slot.seq.load(std::memory_order_acquire) != pos + 1)
+    return false;
+  t = std::move(slot.value);
+  slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+  deqPos_.store(pos + 1, std::memory_order_relaxed);
+  return true;
+}
+//----< pop element, blocking while empty - consumer thread only >----
+/*
+ *  Spins briefly, then parks.  parked_ is set, and the buffer checked
+ *  again, under mtx_, and a producer that publishes after that check
+ *  sees parked_ and notifies under mtx_, so the untimed wait can't
+ *  miss a wake.
+ */
+template<typename T>
+T MpscRingBuffer<T>::deQ() {
+  T temp;
+  size_t spins = 0;
+  while (!tryDeQ(temp)) {
+    if (++spins < 256) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::unique_lock<std::mutex> l(mtx_);
+    parked_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (tryDeQ(temp)) {
+      parked_.store(false, std::memory_order_relaxed);
+      break;
+    }
+    cv_.wait(l, [this]() { return ready(); });
+    parked_.store(false, std::memory_order_relaxed);
+  }
+  return temp;
+}
+//----< append up to maxCount elements, blocking if empty >----------
+
+template<typename T>
+size_t MpscRingBuffer<T>::deQAll(std::vector<T>& batch, size_t maxCount) {
+  if (maxCount == 0)
+    return 0;
+  batch.push_back(deQ());
+  return 1 + tryDeQAll(batch, maxCount - 1);
+}
+//----< append up to maxCount elements, waiting at most timeout >----
+/*
+ *  Spins and parks like deQ(), checking the deadline between waits.
+ */
+template<typename T>
+size_t MpscRingBuffer<T>::deQAllFor(std::vector<T>& batch, size_t maxCount, std::chrono::microseconds timeout) {
+  if (maxCount == 0)
+    return 0;
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  T temp;
+  size_t spins = 0;
+  while (!tryDeQ(temp)) {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline)
+      return 0;
+    if (++spins < 256) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::unique_lock<std::mutex> l(mtx_);
+    parked_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (tryDeQ(temp)) {
+      parked_.store(false, std::memory_order_relaxed);
+      break;
+    }
+    cv_.wait_until(l, deadline, [this]() { return ready(); });
+    parked_.store(false, std::memory_order_relaxed);
+  }
+  batch.push_back(std::move(temp));
+  return 1 + tryDeQAll(batch, maxCount - 1);
+}
+//----< append up to maxCount elements, never blocks >----------------
+
+template<typename T>
+size_t MpscRingBuffer<T>::tryDeQAll(std::vector<T>& batch, size_t maxCount) {
+  size_t count = 0;
+  T temp;
+  while (count < maxCount && tryDeQ(temp)) {
+    batch.push_back(std::move(temp));
+    ++count;
+  }
+  return count;
+}
+//----< return approximate number of elements in buffer >-------------
+
+template<typename T>
+size_t MpscRingBuffer<T>::size() {
+  size_t deq = deqPos_.load(std::memory_order_relaxed);
+  size_t enq = enqPos_.load(std::memory_order_relaxed);
+  return enq > deq ? enq - deq : 0;
+}
+//----< visit queued elements without blocking, returns count >------
+/*
+ *  For crash handlers, see Package Operations.  f is called with
+ *  const T& for each published element, oldest first.
+ */
+template<typename T>
+template<typename F>
+size_t MpscRingBuffer<T>::peekUnsafe(F f) const {
+  size_t pos = deqPos_.load(std::memory_order_acquire);
+  size_t end = enqPos_.load(std::memory_order_acquire);
+  if (end - pos > mask_ + 1)
+    end = pos + mask_ + 1;
+  size_t count = 0;
+  for (; pos < end; ++pos) {
+    const Slot& slot = slots_[pos & mask_];
+    if (slot.seq.load(std::memory_order_acquire) != pos + 1)
+      continue;
+    f(slot.value);
+    ++count;
+  }
+  return count;
+}
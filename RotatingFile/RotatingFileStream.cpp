@@ -0,0 +1,282 @@
+/////////////////////////////////////////////////////////////////////////
+// RotatingFileStream.cpp - std::ostream writing to a rotating         //
+//                          sequence of log files                      //
+// ver 1.0                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+
+#include "RotatingFileStream.h"
+#include <algorithm>
+#include <cctype>
+
+using namespace Test;
+namespace fs = std::filesystem;
+
+/*-----------------------------------------------------
+  open file after the last one an earlier run left
+  - basePath "logs/run.log" writes logs/run.000001.log,
+    logs/run.000002.log, ...
+*/
+RotatingFileBuf::RotatingFileBuf(const std::string& basePath, const RotationPolicy& policy)
+  : policy_(policy) {
+  fs::path base(basePath);
+  dir_ = base.parent_path();
+  if (dir_.empty())
+    dir_ = ".";
+  stem_ = base.stem().string();
+  ext_ = base.extension().string();
+
+  std::error_code ec;
+  fs::create_directories(dir_, ec);
+  size_t last = 0;
+  for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+    size_t index;
+    if (indexOf(it->path().filename().string(), index))
+      last = (std::max)(last, index);
+  }
+  active_ = openFile(last + 1);
+  activeIndex_ = active_.index;
+  scheduleRoll(SysClock::now());
+  helper_ = std::thread(&RotatingFileBuf::helperProc, this);
+}
+/*-- stop helper, close files, remove unused pre-opened file --*/
+RotatingFileBuf::~RotatingFileBuf() {
+  {
+    std::lock_guard<std::mutex> l(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  helper_.join();
+  active_.pFile.reset();
+  retired_.clear();
+  if (next_.pFile) {
+    next_.pFile.reset();
+    std::error_code ec;
+    fs::remove(pathFor(next_.index), ec);
+  }
+  if (policy_.maxTotalBytes > 0)
+    enforceBudget(active_.index);
+}
+/*-- path of file with sequence number index --*/
+std::string RotatingFileBuf::pathFor(size_t index) const {
+  std::string num = std::to_string(index);
+  if (num.size() < 6)
+    num.insert(0, 6 - num.size(), '0');
+  return (dir_ / (stem_ + "." + num + ext_)).string();
+}
+/*-- is fileName stem.NNNNNN.ext, if so extract NNNNNN --*/
+bool RotatingFileBuf::indexOf(const std::string& fileName, size_t& index) const {
+  size_t head = stem_.size() + 1;
+  if (fileName.size() <= head + ext_.size())
+    return false;
+  if (fileName.compare(0, stem_.size(), stem_) != 0 || fileName[stem_.size()] != '.')
+    return false;
+  if (fileName.compare(fileName.size() - ext_.size(), ext_.size(), ext_) != 0)
+    return false;
+  std::string num = fileName.substr(head, fileName.size() - head - ext_.size());
+  if (num.empty() || num.size() > 18)
+    return false;
+  for (char c : num) {
+    if (!std::isdigit(static_cast<unsigned char>(c)))
+      return false;
+  }
+  index = std::stoull(num);
+  return true;
+}
+/*-- create file with sequence number index, pFile null on failure --*/
+RotatingFileBuf::File RotatingFileBuf::openFile(size_t index) const {
+  File file;
+  file.index = index;
+  file.pFile = std::make_unique<std::filebuf>();
+  if (!file.pFile->open(pathFor(index), std::ios::out | std::ios::binary | std::ios::trunc))
+    file.pFile.reset();
+  return file;
+}
+/*-- next wall clock multiple of period, if rolling on time --*/
+void RotatingFileBuf::scheduleRoll(SysClock::time_point now) {
+  if (policy_.period.count() <= 0)
+    return;
+  auto period = std::chrono::duration_cast<SysClock::duration>(policy_.period);
+  auto sinceEpoch = now.time_since_epoch();
+  nextRollTime_ = SysClock::time_point((sinceEpoch / period + 1) * period);
+}
+/*-----------------------------------------------------
+  swap in next file and hand current one to helper
+  - normally the helper has already opened the next
+    file, opening here only if it hasn't
+*/
+void RotatingFileBuf::roll() {
+  std::unique_lock<std::mutex> l(mtx_);
+  cv_.wait(l, [this]() { return !preparing_; });
+  size_t index = active_.index + 1;
+  File fresh = std::move(next_);
+  next_ = File();
+  if (!fresh.pFile || fresh.index != index)
+    fresh = openFile(index);
+  if (!fresh.pFile)
+    return;
+  retired_.push_back(std::move(active_));
+  active_ = std::move(fresh);
+  activeIndex_ = active_.index;
+  activeBytes_ = 0;
+  budgetDirty_ = true;
+  ++rolls_;
+  l.unlock();
+  cv_.notify_all();
+}
+/*-----------------------------------------------------
+  helper thread
+  - opens next file ahead of time
+  - closes retired files, flushing them off the
+    writing thread
+  - enforces disk budget after each roll
+*/
+void RotatingFileBuf::helperProc() {
+  std::unique_lock<std::mutex> l(mtx_);
+  while (true) {
+    cv_.wait(l, [this]() {
+      return stop_ || !retired_.empty() || budgetDirty_ || wantNext();
+    });
+    if (stop_)
+      break;
+    if (wantNext()) {
+      size_t index = activeIndex_ + 1;
+      preparing_ = true;
+      l.unlock();
+      File fresh = openFile(index);
+      l.lock();
+      preparing_ = false;
+      if (fresh.pFile)
+        next_ = std::move(fresh);
+      else
+        failedIndex_ = index;
+      cv_.notify_all();
+    }
+    std::vector<File> retired = std::move(retired_);
+    retired_.clear();
+    bool budget = budgetDirty_;
+    budgetDirty_ = false;
+    size_t activeIndex = activeIndex_;
+    l.unlock();
+    retired.clear();
+    if (budget && policy_.maxTotalBytes > 0)
+      enforceBudget(activeIndex);
+    l.lock();
+  }
+}
+/*-----------------------------------------------------
+  delete, or archive, oldest files until total size
+  of files up to activeIndex fits maxTotalBytes
+  - never touches the active file
+*/
+void RotatingFileBuf::enforceBudget(size_t activeIndex) {
+  struct Entry { size_t index; fs::path path; uint64_t size; };
+  std::vector<Entry> files;
+  uint64_t total = 0;
+  std::error_code ec;
+  for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+    size_t index;
+    if (!indexOf(it->path().filename().string(), index) || index > activeIndex)
+      continue;
+    std::error_code sizeEc;
+    uint64_t size = it->file_size(sizeEc);
+    if (sizeEc)
+      continue;
+    files.push_back({ index, it->path(), size });
+    total += size;
+  }
+  std::sort(files.begin(), files.end(),
+    [](const Entry& a, const Entry& b) { return a.index < b.index; });
+
+  for (const Entry& file : files) {
+    if (total <= policy_.maxTotalBytes || file.index >= activeIndex)
+      break;
+    std::error_code moveEc;
+    if (policy_.archiveDir.empty()) {
+      fs::remove(file.path, moveEc);
+    }
+    else {
+      fs::path target = fs::path(policy_.archiveDir) / file.path.filename();
+      fs::create_directories(policy_.archiveDir, moveEc);
+      fs::rename(file.path, target, moveEc);
+      if (moveEc) {
+        moveEc.clear();
+        if (fs::copy_file(file.path, target, fs::copy_options::overwrite_existing, moveEc))
+          fs::remove(file.path, moveEc);
+      }
+    }
+    if (!moveEc)
+      total -= file.size;
+  }
+}
+/*-- write, rolling first if time is up or data won't fit --*/
+std::streamsize RotatingFileBuf::xsputn(const char* data, std::streamsize count) {
+  if (!active_.pFile)
+    return 0;
+  if (policy_.period.count() > 0) {
+    SysClock::time_point now = SysClock::now();
+    if (now >= nextRollTime_) {
+      roll();
+      scheduleRoll(now);
+    }
+  }
+  uint64_t n = static_cast<uint64_t>(count);
+  if (policy_.maxFileBytes > 0 && activeBytes_ > 0 && activeBytes_ + n > policy_.maxFileBytes)
+    roll();
+  std::streamsize written = active_.pFile->sputn(data, count);
+  activeBytes_ += static_cast<uint64_t>(written);
+  return written;
+}
+/*-- write one character --*/
+RotatingFileBuf::int_type RotatingFileBuf::overflow(int_type ch) {
+  if (traits_type::eq_int_type(ch, traits_type::eof()))
+    return traits_type::not_eof(ch);
+  char c = traits_type::to_char_type(ch);
+  return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+}
+/*-- flush active file --*/
+int RotatingFileBuf::sync() {
+  return active_.pFile ? active_.pFile->pubsync() : -1;
+}
+
+#ifdef TEST_ROTATINGFILESTREAM
+
+#include "../TestLogger/QTestLogger.h"
+#include <iostream>
+
+int main()
+{
+  std::cout << "\n  Demonstrating RotatingFileStream";
+  std::cout << "\n ==================================";
+
+  std::error_code ec;
+  fs::remove_all("rotating", ec);
+
+  RotationPolicy policy;
+  policy.maxFileBytes = 4096;
+  policy.maxTotalBytes = 16 * 1024;
+  policy.archiveDir = "rotating/archive";
+  {
+    RotatingFileStream file("rotating/demo.log", policy);
+    std::cout << "\n  first file: " << file.currentPath();
+
+    Test::RingQTestLogger<> logger;
+    logger.addStream(&file);
+    logger.setPrefix("\n  ");
+    logger.setBatching(16);
+    for (size_t i = 0; i < 2000; ++i)
+      logger.post("rotating file demonstration line " + std::to_string(i));
+    logger.wait();
+    std::cout << "\n  rolled " << file.rollCount() << " times, now writing " << file.currentPath();
+  }
+
+  size_t kept = 0, archived = 0;
+  for (auto& entry : fs::directory_iterator("rotating"))
+    if (entry.is_regular_file()) ++kept;
+  for (auto& entry : fs::directory_iterator("rotating/archive"))
+    if (entry.is_regular_file()) ++archived;
+  std::cout << "\n  " << kept << " files kept within 16 KB budget, " << archived << " archived";
+  std::cout << "\n\n";
+}
+
+#endif
@@ -0,0 +1,137 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// RotatingFileStream.h - std::ostream writing to a rotating sequence  //
+//                        of log files                                 //
+// ver 1.0                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   RotatingFileBuf is a std::streambuf writing to a numbered sequence
+   of files, e.g., run.000001.log, run.000002.log, ...:
+   - it rolls to the next file before a write that would take the
+     current file past maxFileBytes, and when the wall clock crosses
+     a multiple of period, so lines handed over in one write are
+     never split across files
+   - a helper thread opens the next file ahead of time and closes
+     retired ones, so a roll is a pointer swap on the writing thread
+   - the helper thread also enforces a disk budget: once the files
+     total more than maxTotalBytes the oldest are deleted, or moved
+     to archiveDir if one is given
+   - numbering continues after files left by earlier runs
+
+   RotatingFileStream is a std::ostream owning a RotatingFileBuf, so
+   it can be passed to TestLogger and QTestLogger addStream.  With
+   QTestLogger all rolling happens on the write thread, so producers
+   never wait on it.  Writes must be serialized, as the loggers'
+   per-stream locks do.
+
+   Dependencies:
+  ---------------
+   RotatingFileStream.h, RotatingFileStream.cpp
+
+   Maintenance History:
+  ----------------------
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <streambuf>
+#include <ostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <filesystem>
+#include <cstdint>
+
+namespace Test {
+
+  /////////////////////////////////////////////////////////
+  // RotationPolicy
+  // - zero maxFileBytes, period, or maxTotalBytes turns
+  //   that limit off
+
+  struct RotationPolicy {
+    uint64_t maxFileBytes = 64 * 1024 * 1024;
+    std::chrono::seconds period{ 0 };
+    uint64_t maxTotalBytes = 0;
+    std::string archiveDir;
+  };
+
+  /////////////////////////////////////////////////////////
+  // RotatingFileBuf
+
+  class RotatingFileBuf : public std::streambuf {
+  public:
+    using SysClock = std::chrono::system_clock;
+
+    RotatingFileBuf(const std::string& basePath, const RotationPolicy& policy = RotationPolicy());
+    RotatingFileBuf(const RotatingFileBuf&) = delete;
+    RotatingFileBuf& operator=(const RotatingFileBuf&) = delete;
+    ~RotatingFileBuf();
+    bool isOpen() const { return active_.pFile != nullptr; }
+    std::string currentPath() const { return pathFor(active_.index); }
+    size_t rollCount() const { return rolls_; }
+  protected:
+    std::streamsize xsputn(const char* data, std::streamsize count) override;
+    int_type overflow(int_type ch) override;
+    int sync() override;
+  private:
+    struct File {
+      size_t index = 0;
+      std::unique_ptr<std::filebuf> pFile;
+    };
+    std::string pathFor(size_t index) const;
+    bool indexOf(const std::string& fileName, size_t& index) const;
+    bool wantNext() const { return !next_.pFile && failedIndex_ != activeIndex_ + 1; }
+    File openFile(size_t index) const;
+    void roll();
+    void scheduleRoll(SysClock::time_point now);
+    void helperProc();
+    void enforceBudget(size_t activeIndex);
+
+    std::filesystem::path dir_;
+    std::string stem_;
+    std::string ext_;
+    RotationPolicy policy_;
+    File active_;
+    uint64_t activeBytes_ = 0;
+    SysClock::time_point nextRollTime_ = SysClock::time_point::max();
+    size_t rolls_ = 0;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    File next_;
+    std::vector<File> retired_;
+    size_t activeIndex_ = 0;
+    size_t failedIndex_ = 0;
+    bool preparing_ = false;
+    bool budgetDirty_ = false;
+    bool stop_ = false;
+    std::thread helper_;
+  };
+
+  /////////////////////////////////////////////////////////
+  // RotatingFileStream
+
+  class RotatingFileStream : public std::ostream {
+  public:
+    RotatingFileStream(const std::string& basePath, const RotationPolicy& policy = RotationPolicy())
+      : std::ostream(nullptr), buf_(basePath, policy) {
+      rdbuf(&buf_);
+      if (!buf_.isOpen())
+        setstate(std::ios::failbit);
+    }
+    bool isOpen() const { return buf_.isOpen(); }
+    std::string currentPath() const { return buf_.currentPath(); }
+    size_t rollCount() const { return buf_.rollCount(); }
+  private:
+    RotatingFileBuf buf_;
+  };
+}
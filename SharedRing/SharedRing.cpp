@@ -0,0 +1,345 @@
+/////////////////////////////////////////////////////////////////////////
+// SharedRing.cpp - Log sink publishing records to shared memory       //
+// ver 1.1                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+
+#include "SharedRing.h"
+#include <new>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace Test;
+
+/*-- ring name for pid, a POSIX shm name or Windows mapping name --*/
+std::string Test::sharedRingName(uint32_t pid) {
+#ifdef _WIN32
+  return "Local\\testlogger." + std::to_string(pid);
+#else
+  return "/testlogger." + std::to_string(pid);
+#endif
+}
+uint32_t Test::currentProcessId() {
+#ifdef _WIN32
+  return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+  return static_cast<uint32_t>(::getpid());
+#endif
+}
+
+//----< SharedRingMapping >--------------------------------------------
+
+/*-- create, or replace, named shared memory of size bytes, zero filled --*/
+bool SharedRingMapping::create(const std::string& name, size_t size) {
+  close();
+#ifdef _WIN32
+  HANDLE hMap = CreateFileMappingA(
+    INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+    static_cast<DWORD>(static_cast<uint64_t>(size) >> 32), static_cast<DWORD>(size & 0xffffffff),
+    name.c_str()
+  );
+  if (hMap == nullptr)
+    return false;
+  void* p = MapViewOfFile(hMap, FILE_MAP_WRITE, 0, 0, size);
+  if (p == nullptr) {
+    CloseHandle(hMap);
+    return false;
+  }
+  hMapping_ = hMap;
+#else
+  ::shm_unlink(name.c_str());
+  int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0)
+    return false;
+  if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    return false;
+  }
+  void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    ::shm_unlink(name.c_str());
+    return false;
+  }
+#endif
+  name_ = name;
+  pBase_ = static_cast<char*>(p);
+  size_ = size;
+  owner_ = true;
+  return true;
+}
+/*-- map existing named shared memory for reading --*/
+bool SharedRingMapping::openReadOnly(const std::string& name) {
+  close();
+#ifdef _WIN32
+  HANDLE hMap = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+  if (hMap == nullptr)
+    return false;
+  void* p = MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+  if (p == nullptr) {
+    CloseHandle(hMap);
+    return false;
+  }
+  MEMORY_BASIC_INFORMATION info;
+  VirtualQuery(p, &info, sizeof(info));
+  hMapping_ = hMap;
+  size_ = info.RegionSize;
+#else
+  int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    size_ = 0;
+    return false;
+  }
+#endif
+  name_ = name;
+  pBase_ = static_cast<char*>(p);
+  owner_ = false;
+  return true;
+}
+/*-- unmap, removing the name if this mapping created it --*/
+void SharedRingMapping::close() {
+  if (pBase_ == nullptr)
+    return;
+#ifdef _WIN32
+  UnmapViewOfFile(pBase_);
+  CloseHandle(hMapping_);
+  hMapping_ = nullptr;
+#else
+  ::munmap(pBase_, size_);
+  if (owner_)
+    ::shm_unlink(name_.c_str());
+#endif
+  pBase_ = nullptr;
+  size_ = 0;
+  owner_ = false;
+}
+
+//----< SharedRingSink >-----------------------------------------------
+
+/*-----------------------------------------------------
+  create ring of slotCount slots of slotSize bytes
+  - slotCount is rounded up to a power of two
+  - slotSize is rounded up to a multiple of 64, and
+    holds a slot header and the record's text
+*/
+SharedRingSink::SharedRingSink(const std::string& name, size_t slotCount, size_t slotSize)
+  : name_(name.empty() ? sharedRingName(currentProcessId()) : name) {
+  size_t count = 1;
+  while (count < slotCount)
+    count <<= 1;
+  if (slotSize < sizeof(SharedRingSlot) + 64)
+    slotSize = sizeof(SharedRingSlot) + 64;
+  slotSize_ = (slotSize + 63) / 64 * 64;
+  mask_ = count - 1;
+  size_t size = sizeof(SharedRingHeader) + count * slotSize_;
+  if (!mapping_.create(name_, size))
+    return;
+  pHeader_ = new (mapping_.data()) SharedRingHeader();
+  pHeader_->version = SharedRingHeader::versionValue;
+  pHeader_->slotSize = static_cast<uint32_t>(slotSize_);
+  pHeader_->slotCount = static_cast<uint32_t>(count);
+  pHeader_->pid = currentProcessId();
+  pHeader_->closed.store(0, std::memory_order_relaxed);
+  pHeader_->head.store(0, std::memory_order_relaxed);
+  pSlots_ = mapping_.data() + sizeof(SharedRingHeader);
+  for (size_t i = 0; i < count; ++i)
+    new (pSlots_ + i * slotSize_) SharedRingSlot();
+  pHeader_->magic.store(SharedRingHeader::magicValue, std::memory_order_release);
+}
+/*-- publish one record, seqlock protocol in SharedRing.h --*/
+void SharedRingSink::publish(const char* p, size_t n, uint32_t flags) {
+  SharedRingSlot& s = *reinterpret_cast<SharedRingSlot*>(pSlots_ + (next_ & mask_) * slotSize_);
+  s.seq.store(2 * next_ + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(s.payload(), p, n);
+  s.length.store(static_cast<uint32_t>(n), std::memory_order_relaxed);
+  s.flags.store(flags, std::memory_order_relaxed);
+  s.seq.store(2 * next_ + 2, std::memory_order_release);
+  ++next_;
+  pHeader_->head.store(next_, std::memory_order_release);
+}
+/*-- publish text of one line, flagging its first record if a newline preceded it --*/
+void SharedRingSink::publishLine(const char* p, size_t n) {
+  size_t payloadSize = slotSize_ - sizeof(SharedRingSlot);
+  do {
+    size_t part = n < payloadSize ? n : payloadSize;
+    publish(p, part, newlinePending_ ? SharedRingSlot::startsLine : 0);
+    newlinePending_ = false;
+    p += part;
+    n -= part;
+  } while (n > 0);
+}
+/*-----------------------------------------------------
+  split data into line records and publish them
+  - a newline is held for the next line's first record,
+    only a second newline in a row publishes an empty
+    record, for the blank line between them
+*/
+bool SharedRingSink::write(std::string_view data) {
+  if (pHeader_ == nullptr)
+    return false;
+  size_t pos = 0;
+  while (pos < data.size()) {
+    size_t newline = data.find('\n', pos);
+    size_t end = newline == std::string_view::npos ? data.size() : newline;
+    if (end > pos)
+      publishLine(data.data() + pos, end - pos);
+    if (newline == std::string_view::npos)
+      break;
+    if (end == pos && newlinePending_)
+      publishLine(data.data() + pos, 0);
+    newlinePending_ = true;
+    pos = newline + 1;
+  }
+  return true;
+}
+/*-- mark ring closed for readers, then unmap and remove it --*/
+void SharedRingSink::close() {
+  if (pHeader_ == nullptr)
+    return;
+  pHeader_->closed.store(1, std::memory_order_release);
+  mapping_.close();
+  pHeader_ = nullptr;
+  pSlots_ = nullptr;
+}
+
+//----< SharedRingReader >---------------------------------------------
+
+/*-----------------------------------------------------
+  attach to named ring
+  - fromOldest starts with the oldest records still
+    safely readable, otherwise with the next record
+*/
+bool SharedRingReader::attach(const std::string& name, bool fromOldest) {
+  detach();
+  if (!mapping_.openReadOnly(name))
+    return false;
+  if (mapping_.size() < sizeof(SharedRingHeader)) {
+    mapping_.close();
+    return false;
+  }
+  auto pHeader = reinterpret_cast<const SharedRingHeader*>(mapping_.data());
+  uint64_t magic = pHeader->magic.load(std::memory_order_acquire);
+  size_t count = pHeader->slotCount;
+  size_t slotSize = pHeader->slotSize;
+  if (magic != SharedRingHeader::magicValue ||
+    pHeader->version != SharedRingHeader::versionValue || count == 0 || (count & (count - 1)) != 0 ||
+    slotSize <= sizeof(SharedRingSlot) || mapping_.size() < sizeof(SharedRingHeader) + count * slotSize) {
+    mapping_.close();
+    return false;
+  }
+  pHeader_ = pHeader;
+  pSlots_ = mapping_.data() + sizeof(SharedRingHeader);
+  slotSize_ = slotSize;
+  mask_ = count - 1;
+  lost_ = 0;
+  pendingGap_ = 0;
+  uint64_t head = pHeader_->head.load(std::memory_order_acquire);
+  size_t half = count / 2;
+  next_ = !fromOldest ? head : (head > half ? head - half : 0);
+  return true;
+}
+void SharedRingReader::detach() {
+  mapping_.close();
+  pHeader_ = nullptr;
+  pSlots_ = nullptr;
+}
+/*-----------------------------------------------------
+  skip records the writer has overwritten, or is about
+  to, restarting half a ring behind head
+*/
+void SharedRingReader::resync(uint64_t head) {
+  uint64_t half = (mask_ + 1) / 2;
+  uint64_t target = head > half ? head - half : 0;
+  if (target <= next_)
+    target = next_ + 1;
+  lost_ += target - next_;
+  pendingGap_ += target - next_;
+  next_ = target;
+}
+/*-- has the writer closed its sink --*/
+bool SharedRingReader::writerClosed() const {
+  return pHeader_ == nullptr || pHeader_->closed.load(std::memory_order_acquire) != 0;
+}
+/*-- is the writing process still running --*/
+bool SharedRingReader::writerAlive() const {
+  if (writerClosed())
+    return false;
+#ifdef _WIN32
+  HANDLE h = OpenProcess(SYNCHRONIZE, FALSE, pHeader_->pid);
+  if (h == nullptr)
+    return false;
+  bool alive = WaitForSingleObject(h, 0) == WAIT_TIMEOUT;
+  CloseHandle(h);
+  return alive;
+#else
+  return ::kill(static_cast<pid_t>(pHeader_->pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+#ifdef TEST_SHAREDRING
+
+#include "../TestLogger/TestLogger.h"
+#include <iostream>
+
+int main()
+{
+  std::cout << "\n  Demonstrating SharedRingSink and SharedRingReader";
+  std::cout << "\n ===================================================";
+
+  SharedRingSink sink("", 64, 128);
+  std::cout << "\n  created ring " << sink.name() << ": " << std::boolalpha << sink.isOpen();
+
+  SharedRingReader reader;
+  std::cout << "\n  reader attached: " << reader.attach(sink.name());
+
+  TestLogger<Level::all> logger;
+  logger.addSink(&sink);
+  logger.setPrefix("\n  ");
+  for (int i = 0; i < 5; ++i)
+    logger.post("shared ring post #" + std::to_string(i));
+
+  auto show = [](const SharedRingReader::Record& rec) {
+    if (!rec.text.empty())
+      std::cout << "\n    read " << rec.seq << ": " << rec.text;
+  };
+  auto gap = [](uint64_t count) {
+    std::cout << "\n    -- " << count << " records lost, reader fell behind --";
+  };
+  reader.poll(show, gap);
+
+  for (int i = 0; i < 200; ++i)
+    logger.post("burst post #" + std::to_string(i));
+  std::cout << "\n\n  200 more posts, with the reader idle, into a 64 slot ring:";
+  reader.poll(show, gap);
+  std::cout << "\n  writer published " << sink.records() << " records, reader lost " << reader.lost();
+
+  logger.clear();
+  sink.close();
+  std::cout << "\n  after close, writer closed: " << reader.writerClosed();
+  std::cout << "\n\n";
+}
+
+#endif
@@ -0,0 +1,274 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// SharedRing.h - Log sink publishing records to shared memory         //
+// ver 1.1                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Lets another process watch a logger's output live, with no file and
+   no write() calls:
+   - SharedRingSink is an ISink that copies each line it is given into
+     the next slot of a ring in shared memory, a POSIX shm_open object,
+     or a named file mapping on Windows.  The ring is named for the
+     writing process, see sharedRingName(pid), and removed when the
+     sink closes.
+   - SharedRingReader attaches to a running process's ring, read only,
+     and hands each new record to a callback once the seqlock shows it
+     was read whole.  An optional filter runs on the text in place, in
+     shared memory, and only records it accepts are copied, into a
+     buffer the reader reuses, then checked and delivered.
+   - LogTail, the companion tool, streams or filters a ring's records.
+
+   Each slot has a sequence word used as a seqlock.  For record n the
+   writer stores 2n+1, copies the text, then stores 2n+2 and advances
+   the ring's head.  A reader accepts slot contents only if the slot
+   holds 2n+2 before and after it reads them.  The writer never waits
+   for readers.  A reader that falls more than a ring behind finds
+   newer sequence numbers, counts the records it missed as lost, and
+   resynchronizes half a ring behind the head.
+
+   A write is split at newlines, so each record is one line, without
+   its newline, flagged if a newline preceded it.  A newline is held
+   until the next text arrives, so a "\n  " prefix costs no record of
+   its own, and only blank lines publish empty records.  Lines longer
+   than a slot span several records, only the first flagged.
+
+   Writes must be serialized, as the loggers' per-sink locks do.
+
+   Dependencies:
+  ---------------
+   SharedRing.h, SharedRing.cpp
+   LogSinks.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.1 : 16 Oct 2026
+   - reader validates records before delivering them, and attach
+     checks the mapping's size before reading the header
+   - records are flagged by the newline before them, so a leading
+     newline no longer publishes an empty record, ring version 2
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include "../TestLogger/LogSinks.h"
+#include <string>
+#include <string_view>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace Test {
+
+  /////////////////////////////////////////////////////////
+  // Shared memory layout, identical in every process
+
+  struct alignas(64) SharedRingHeader {
+    static constexpr uint64_t magicValue = 0x474e4952474f4c54;  // "TLOGRING"
+    static constexpr uint32_t versionValue = 2;
+
+    std::atomic<uint64_t> magic;
+    uint32_t version;
+    uint32_t slotSize;
+    uint32_t slotCount;
+    uint32_t pid;
+    std::atomic<uint32_t> closed;
+    alignas(64) std::atomic<uint64_t> head;
+  };
+
+  struct SharedRingSlot {
+    static constexpr uint32_t startsLine = 1;
+
+    std::atomic<uint64_t> seq;
+    std::atomic<uint32_t> length;
+    std::atomic<uint32_t> flags;
+    char* payload() { return reinterpret_cast<char*>(this + 1); }
+    const char* payload() const { return reinterpret_cast<const char*>(this + 1); }
+  };
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared ring needs lock-free 64 bit atomics");
+
+  /*-- name of ring published by process pid --*/
+  std::string sharedRingName(uint32_t pid);
+  uint32_t currentProcessId();
+
+  /////////////////////////////////////////////////////////
+  // SharedRingMapping - platform mapping of a named ring
+
+  class SharedRingMapping {
+  public:
+    SharedRingMapping() {}
+    SharedRingMapping(const SharedRingMapping&) = delete;
+    SharedRingMapping& operator=(const SharedRingMapping&) = delete;
+    ~SharedRingMapping() { close(); }
+    bool create(const std::string& name, size_t size);
+    bool openReadOnly(const std::string& name);
+    void close();
+    char* data() const { return pBase_; }
+    size_t size() const { return size_; }
+  private:
+    std::string name_;
+    char* pBase_ = nullptr;
+    size_t size_ = 0;
+    bool owner_ = false;
+#ifdef _WIN32
+    void* hMapping_ = nullptr;
+#endif
+  };
+
+  /////////////////////////////////////////////////////////
+  // SharedRingSink - writes records, never blocks on readers
+
+  class SharedRingSink : public ISink {
+  public:
+    static constexpr size_t defaultSlotCount = 4096;
+    static constexpr size_t defaultSlotSize = 256;
+
+    /*-- empty name uses sharedRingName of this process --*/
+    SharedRingSink(
+      const std::string& name = "", size_t slotCount = defaultSlotCount,
+      size_t slotSize = defaultSlotSize
+    );
+    SharedRingSink(const SharedRingSink&) = delete;
+    SharedRingSink& operator=(const SharedRingSink&) = delete;
+    ~SharedRingSink() { close(); }
+    bool isOpen() const { return pHeader_ != nullptr; }
+    const std::string& name() const { return name_; }
+    uint64_t records() const { return next_; }
+    virtual bool write(std::string_view data) override;
+    virtual void flush() override {}
+    virtual void close() override;
+  private:
+    void publish(const char* p, size_t n, uint32_t flags);
+    void publishLine(const char* p, size_t n);
+
+    std::string name_;
+    SharedRingMapping mapping_;
+    SharedRingHeader* pHeader_ = nullptr;
+    char* pSlots_ = nullptr;
+    size_t slotSize_ = 0;
+    size_t mask_ = 0;
+    uint64_t next_ = 0;
+    bool newlinePending_ = false;
+  };
+
+  /////////////////////////////////////////////////////////
+  // SharedRingReader - reads another process's ring, never blocking it
+
+  class SharedRingReader {
+  public:
+    struct Record {
+      uint64_t seq = 0;
+      std::string_view text;
+      bool startsLine = false;
+    };
+
+    SharedRingReader() {}
+    SharedRingReader(const SharedRingReader&) = delete;
+    SharedRingReader& operator=(const SharedRingReader&) = delete;
+    bool attach(const std::string& name, bool fromOldest = false);
+    void detach();
+    bool isAttached() const { return pHeader_ != nullptr; }
+    uint32_t pid() const { return pHeader_ != nullptr ? pHeader_->pid : 0; }
+    uint64_t lost() const { return lost_; }
+    bool pending() const { return isAttached() && next_ < pHeader_->head.load(std::memory_order_acquire); }
+    bool writerClosed() const;
+    bool writerAlive() const;
+    template<typename F, typename G>
+    size_t poll(F onRecord, G onGap, size_t maxRecords = SIZE_MAX);
+    template<typename A, typename F, typename G>
+    size_t pollMatching(A accept, F onRecord, G onGap, size_t maxRecords = SIZE_MAX);
+  private:
+    const SharedRingSlot& slot(uint64_t n) const {
+      return *reinterpret_cast<const SharedRingSlot*>(pSlots_ + (n & mask_) * slotSize_);
+    }
+    void resync(uint64_t head);
+
+    SharedRingMapping mapping_;
+    const SharedRingHeader* pHeader_ = nullptr;
+    const char* pSlots_ = nullptr;
+    size_t slotSize_ = 0;
+    size_t mask_ = 0;
+    uint64_t next_ = 0;
+    uint64_t lost_ = 0;
+    uint64_t pendingGap_ = 0;
+    std::string copy_;
+  };
+
+  /*-----------------------------------------------------
+    hand records published since the last poll to
+    onRecord(const Record&), in order, and the count of
+    records missed to onGap(count)
+    - text views point into the reader's copy and are
+      valid only during the call
+  */
+  template<typename F, typename G>
+  size_t SharedRingReader::poll(F onRecord, G onGap, size_t maxRecords) {
+    return pollMatching([](std::string_view) { return true; }, onRecord, onGap, maxRecords);
+  }
+  /*-----------------------------------------------------
+    poll, handing onRecord only records for which
+    accept(std::string_view) is true
+    - accept reads the text in shared memory, where the
+      writer may be overwriting it, so it must only
+      inspect the view
+    - accepted records are copied, then the slot's
+      sequence is checked again, and a record overwritten
+      meanwhile goes to onGap instead of onRecord
+    - records not accepted are never copied
+  */
+  template<typename A, typename F, typename G>
+  size_t SharedRingReader::pollMatching(A accept, F onRecord, G onGap, size_t maxRecords) {
+    if (!isAttached())
+      return 0;
+    size_t count = 0;
+    size_t payloadSize = slotSize_ - sizeof(SharedRingSlot);
+    while (count < maxRecords) {
+      uint64_t head = pHeader_->head.load(std::memory_order_acquire);
+      if (next_ >= head)
+        break;
+      if (head - next_ > mask_ + 1)
+        resync(head);
+      if (pendingGap_ > 0) {
+        onGap(pendingGap_);
+        pendingGap_ = 0;
+      }
+      const SharedRingSlot& s = slot(next_);
+      uint64_t expected = 2 * next_ + 2;
+      uint64_t seq = s.seq.load(std::memory_order_acquire);
+      if (seq != expected) {
+        if (seq < expected)
+          break;
+        resync(pHeader_->head.load(std::memory_order_acquire));
+        continue;
+      }
+      size_t length = s.length.load(std::memory_order_relaxed);
+      std::string_view shared(s.payload(), length < payloadSize ? length : payloadSize);
+      bool startsLine = (s.flags.load(std::memory_order_relaxed) & SharedRingSlot::startsLine) != 0;
+      bool accepted = accept(shared);
+      if (accepted)
+        copy_.assign(shared.data(), shared.size());
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s.seq.load(std::memory_order_relaxed) != expected) {
+        ++lost_;
+        onGap(1);
+      }
+      else if (accepted) {
+        Record rec;
+        rec.seq = next_;
+        rec.text = copy_;
+        rec.startsLine = startsLine;
+        onRecord(rec);
+      }
+      ++next_;
+      ++count;
+    }
+    if (pendingGap_ > 0) {
+      onGap(pendingGap_);
+      pendingGap_ = 0;
+    }
+    return count;
+  }
+}
@@ -0,0 +1,182 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// AsyncPost.h - Completions of queued posts, and C++20 awaitable post //
+// ver 1.2                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Lets a caller learn that its post has been written without blocking
+   a thread in QTestLogger::wait():
+   - WriteCompletion is a node the waiter owns, holding the post's
+     ticket and a function to call when done.
+     QTestLogger::whenWritten(pNode) registers it, and returns false,
+     registering nothing, if the ticket is already written.
+   - CompletionHeap keeps registered nodes ordered by ticket.  Each time
+     messages are published as written, see QTestLogger's Durability,
+     every ready node is taken under one lock, then each node's
+     complete function is called.  Thousands of waiters cost one lock
+     per batch, and no threads.
+   - With C++20 coroutines, __cpp_impl_coroutine defined, e.g., MSVC's
+     /std:c++20:
+       co_await postAsync(logger, "step done");
+       co_await postAsync(logger, MessageBuilder() << "saved " << n, Durability::fsynced);
+     postAsync queues the post, with the logger's durability or the one
+     given, and returns a PostAwaiter, itself the WriteCompletion, that
+     resumes the coroutine once the post has been written, flushed, or
+     synced to every sink, as its durability requires.  A post filtered
+     by logLevel or dropped by an overflow policy resumes at once.
+
+   Coroutines resume on the logger's write thread, or in fan-out mode
+   on the stream thread completing the post.  They should post, or hand
+   themselves back to their own scheduler, not block or reconfigure the
+   logger, until they next suspend.  Posts made while completing never
+   block, since only the write thread can make room: inCompletion() is
+   true on the completing thread, and a post that would wait for space
+   is queued past the logger's capacity instead.  Only a full
+   RingQTestLogger ring, which can't grow, drops such posts, counting
+   them in dropped(level).
+
+   postAsync needs C++20 coroutines.  Built as C++17 the completions
+   remain, but PostAwaiter and postAsync are compiled out.
+
+   Dependencies:
+  ---------------
+   AsyncPost.h
+   LogSinks.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.2 : 16 Oct 2026
+   - added inCompletion(), posts made from completions never block,
+     they are queued past capacity
+   ver 1.1 : 16 Oct 2026
+   - completions no longer flush, posts carry their own Durability
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+#include "LogSinks.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define TESTLOGGER_HAS_COROUTINES 1
+#endif
+
+namespace Test {
+
+  /////////////////////////////////////////////////////////
+  // WriteCompletion - waiter's node, must outlive its wait
+
+  struct WriteCompletion {
+    size_t ticket = 0;
+    void (*complete)(WriteCompletion* pSelf) = nullptr;
+  };
+
+  /*-- is this thread running completions, whose posts must not block --*/
+  inline bool& inCompletion() {
+    thread_local bool completing = false;
+    return completing;
+  }
+
+  /////////////////////////////////////////////////////////
+  // CompletionHeap - registered completions, earliest first
+
+  class CompletionHeap {
+  public:
+    bool add(WriteCompletion* pDone, const std::atomic<size_t>& written);
+    bool empty() const { return count_.load() == 0; }
+    void takeReady(size_t written, std::vector<WriteCompletion*>& ready);
+  private:
+    static bool later(const WriteCompletion* a, const WriteCompletion* b) {
+      return a->ticket > b->ticket;
+    }
+    std::mutex mtx_;
+    std::vector<WriteCompletion*> heap_;
+    std::atomic<size_t> count_{ 0 };
+  };
+
+  /*-----------------------------------------------------
+    register pDone unless written already covers it
+    - count_ is raised before written is read, and the
+      write thread raises written before reading count_,
+      so one of them always sees the other
+  */
+  inline bool CompletionHeap::add(WriteCompletion* pDone, const std::atomic<size_t>& written) {
+    std::lock_guard<std::mutex> l(mtx_);
+    count_.fetch_add(1);
+    if (written.load() >= pDone->ticket) {
+      count_.fetch_sub(1);
+      return false;
+    }
+    heap_.push_back(pDone);
+    std::push_heap(heap_.begin(), heap_.end(), later);
+    return true;
+  }
+  /*-- move completions with tickets up to written to ready --*/
+  inline void CompletionHeap::takeReady(size_t written, std::vector<WriteCompletion*>& ready) {
+    std::lock_guard<std::mutex> l(mtx_);
+    while (!heap_.empty() && heap_.front()->ticket <= written) {
+      std::pop_heap(heap_.begin(), heap_.end(), later);
+      ready.push_back(heap_.back());
+      heap_.pop_back();
+    }
+    count_.store(heap_.size());
+  }
+
+#ifdef TESTLOGGER_HAS_COROUTINES
+
+  /////////////////////////////////////////////////////////
+  // PostAwaiter - awaitable returned by postAsync
+
+  template<typename Logger>
+  class PostAwaiter : private WriteCompletion {
+  public:
+    PostAwaiter(Logger& logger, size_t ticket) : logger_(logger) {
+      this->ticket = ticket;
+      this->complete = &PostAwaiter::resume;
+    }
+    PostAwaiter(const PostAwaiter&) = delete;
+    PostAwaiter& operator=(const PostAwaiter&) = delete;
+
+    bool await_ready() const noexcept { return ticket == 0; }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      handle_ = handle;
+      return logger_.whenWritten(this);
+    }
+    void await_resume() const noexcept {}
+  private:
+    static void resume(WriteCompletion* pSelf) {
+      static_cast<PostAwaiter*>(pSelf)->handle_.resume();
+    }
+    Logger& logger_;
+    std::coroutine_handle<> handle_;
+  };
+
+  /*-----------------------------------------------------
+    queue msg, returning an awaitable that resumes when
+    it is written with the logger's durability
+    - logger is a QTestLogger or RingQTestLogger
+    - called from a resumed coroutine, msg never waits
+      for queue space: it is queued past setCapacity's
+      limits, and dropped only if a RingQTestLogger's
+      ring is full, resuming at once
+  */
+  template<typename Logger, typename Msg>
+  inline PostAwaiter<Logger> postAsync(Logger& logger, const Msg& msg) {
+    return PostAwaiter<Logger>(logger, logger.postTicket(msg));
+  }
+  /*-- queue msg, resuming once it is written with durability --*/
+  template<typename Logger, typename Msg>
+  inline PostAwaiter<Logger> postAsync(Logger& logger, const Msg& msg, Durability durability) {
+    return PostAwaiter<Logger>(logger, logger.postTicket(msg, durability));
+  }
+
+#endif
+}
@@ -0,0 +1,241 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// CallSite.h - Per-call-site log metadata and runtime toggles         //
+// ver 1.0                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Gives every TEST_POST, TEST_POST_DATED, and TEST_POST_DEFERRED call
+   site an identity that can be switched off and counted at run time:
+   - CallSite holds a site's file, line, function, logger level, and
+     format, the format string of deferred posts or the text of the
+     message expression of others.  The macros create one static
+     CallSite per site, registered the first time the site runs.
+   - each site has an enabled flag, read with one relaxed load, so a
+     disabled site costs one predictable branch, and a hit counter of
+     the posts it has made.
+   - CallSiteRegistry, callSites(), lists every registered site:
+     - enable(pattern) and disable(pattern) switch on or off sites
+       whose file path, file name, "file:line", function, or format
+       matches pattern, a glob with * and ?.  Rules are kept, so
+       sites first run later follow them too, the last matching
+       rule winning.
+     - top(n) returns the n sites with most hits, showTop(out, n)
+       writes them as a table, resetHits() zeroes all counters.
+     - setShowLocation(true) prefixes text posts from sites with
+       "file:line", and adds a "site" field to structured posts.
+
+   Dependencies:
+  ---------------
+   CallSite.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <cstdint>
+
+namespace Test {
+
+  enum class Level;  // see ITestLogger.h
+
+  /*-----------------------------------------------------
+    does text match glob pattern
+    - * matches any run of chars, ? any one char
+  */
+  inline bool globMatch(std::string_view pattern, std::string_view text) {
+    size_t p = 0, t = 0;
+    size_t starP = std::string_view::npos, starT = 0;
+    while (t < text.size()) {
+      if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+        ++p;
+        ++t;
+      }
+      else if (p < pattern.size() && pattern[p] == '*') {
+        starP = p++;
+        starT = t;
+      }
+      else if (starP != std::string_view::npos) {
+        p = starP + 1;
+        t = ++starT;
+      }
+      else {
+        return false;
+      }
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+      ++p;
+    return p == pattern.size();
+  }
+
+  /////////////////////////////////////////////////////////
+  // CallSite - static metadata of one logging statement
+
+  class CallSite {
+  public:
+    CallSite(const char* file, int line, const char* function, Level level, const char* format);
+    CallSite(const CallSite&) = delete;
+    CallSite& operator=(const CallSite&) = delete;
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void setEnabled(bool on) { enabled_.store(on, std::memory_order_relaxed); }
+    void hit() { hits_.fetch_add(1, std::memory_order_relaxed); }
+    uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    void resetHits() { hits_.store(0, std::memory_order_relaxed); }
+
+    const char* file() const { return file_; }
+    std::string_view fileName() const;
+    int line() const { return line_; }
+    const char* function() const { return function_; }
+    Level level() const { return level_; }
+    const char* format() const { return format_; }
+    /*-- "file:line", file without directories --*/
+    const std::string& location() const { return location_; }
+    bool matches(std::string_view pattern) const;
+  private:
+    const char* file_;
+    int line_;
+    const char* function_;
+    Level level_;
+    const char* format_;
+    std::string location_;
+    std::atomic<bool> enabled_{ true };
+    std::atomic<uint64_t> hits_{ 0 };
+  };
+
+  /*-- file name without directories --*/
+  inline std::string_view CallSite::fileName() const {
+    std::string_view path(file_);
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+  }
+  /*-- does pattern match file, file name, location, function, or format --*/
+  inline bool CallSite::matches(std::string_view pattern) const {
+    return globMatch(pattern, file_) || globMatch(pattern, fileName()) ||
+      globMatch(pattern, location_) || globMatch(pattern, function_) ||
+      globMatch(pattern, format_);
+  }
+
+  /////////////////////////////////////////////////////////
+  // CallSiteRegistry - every site registered so far
+
+  class CallSiteRegistry {
+  public:
+    void add(CallSite* pSite);
+    size_t enable(std::string_view pattern, bool on = true);
+    size_t disable(std::string_view pattern) { return enable(pattern, false); }
+    void clearRules();
+    std::vector<const CallSite*> top(size_t n);
+    void showTop(std::ostream& out, size_t n);
+    void resetHits();
+    size_t size();
+    void setShowLocation(bool on) { showLocation_.store(on, std::memory_order_relaxed); }
+    bool showLocation() const { return showLocation_.load(std::memory_order_relaxed); }
+  private:
+    struct Rule {
+      std::string pattern;
+      bool on;
+    };
+    std::mutex mtx_;
+    std::vector<CallSite*> sites_;
+    std::vector<Rule> rules_;
+    std::atomic<bool> showLocation_{ false };
+  };
+
+  inline CallSiteRegistry& callSites() {
+    static CallSiteRegistry registry;
+    return registry;
+  }
+
+  inline CallSite::CallSite(const char* file, int line, const char* function, Level level, const char* format)
+    : file_(file), line_(line), function_(function), level_(level), format_(format) {
+    location_.append(fileName()).append(":").append(std::to_string(line));
+    callSites().add(this);
+  }
+
+  /*-- register site, applying rules made so far --*/
+  inline void CallSiteRegistry::add(CallSite* pSite) {
+    std::lock_guard<std::mutex> l(mtx_);
+    for (auto& rule : rules_) {
+      if (pSite->matches(rule.pattern))
+        pSite->setEnabled(rule.on);
+    }
+    sites_.push_back(pSite);
+  }
+  /*-----------------------------------------------------
+    switch sites matching pattern on or off, now and
+    when first run, returns number of sites matched
+  */
+  inline size_t CallSiteRegistry::enable(std::string_view pattern, bool on) {
+    std::lock_guard<std::mutex> l(mtx_);
+    rules_.push_back(Rule{ std::string(pattern), on });
+    size_t count = 0;
+    for (auto pSite : sites_) {
+      if (pSite->matches(pattern)) {
+        pSite->setEnabled(on);
+        ++count;
+      }
+    }
+    return count;
+  }
+  /*-- forget rules, enabling every site --*/
+  inline void CallSiteRegistry::clearRules() {
+    std::lock_guard<std::mutex> l(mtx_);
+    rules_.clear();
+    for (auto pSite : sites_)
+      pSite->setEnabled(true);
+  }
+  /*-- n sites with most hits, most first --*/
+  inline std::vector<const CallSite*> CallSiteRegistry::top(size_t n) {
+    std::vector<std::pair<uint64_t, const CallSite*>> counts;
+    {
+      std::lock_guard<std::mutex> l(mtx_);
+      for (auto pSite : sites_)
+        counts.emplace_back(pSite->hits(), pSite);
+    }
+    n = std::min(n, counts.size());
+    std::partial_sort(counts.begin(), counts.begin() + n, counts.end(),
+      [](const auto& a, const auto& b) { return a.first > b.first; }
+    );
+    std::vector<const CallSite*> sites;
+    for (size_t i = 0; i < n; ++i)
+      sites.push_back(counts[i].second);
+    return sites;
+  }
+  /*-- write n hottest sites as a table --*/
+  inline void CallSiteRegistry::showTop(std::ostream& out, size_t n) {
+    static const char* names[] = { "?", "results", "demo", "?", "debug", "?", "?", "all" };
+    out << "\n  " << std::right << std::setw(10) << "hits" << "  " << std::left << std::setw(8) << "level"
+      << std::setw(4) << "on" << std::setw(24) << "location" << "function: format";
+    for (auto pSite : top(n)) {
+      size_t level = static_cast<size_t>(pSite->level());
+      out << "\n  " << std::right << std::setw(10) << pSite->hits() << "  " << std::left
+        << std::setw(8) << (level < 8 ? names[level] : "?")
+        << std::setw(4) << (pSite->enabled() ? "yes" : "no")
+        << std::setw(24) << pSite->location() << pSite->function() << ": " << pSite->format();
+    }
+    out << std::right;
+  }
+  inline void CallSiteRegistry::resetHits() {
+    std::lock_guard<std::mutex> l(mtx_);
+    for (auto pSite : sites_)
+      pSite->resetHits();
+  }
+  inline size_t CallSiteRegistry::size() {
+    std::lock_guard<std::mutex> l(mtx_);
+    return sites_.size();
+  }
+}
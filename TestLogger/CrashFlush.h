@@ -0,0 +1,228 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// CrashFlush.h - Write queued log messages on fatal signals           //
+// ver 1.0                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Lets queued loggers save messages still waiting for their write
+   thread when the process dies on SIGSEGV, SIGABRT, SIGBUS, or SIGFPE:
+   - ICrashFlush is implemented by loggers, see
+     QTestLogger::enableCrashFlush(fds).
+   - CrashHandler keeps a fixed table of registered ICrashFlush
+     clients.  The first registration installs a handler for each
+     fatal signal.  The handler calls every client's crashFlush(sig),
+     restores the signal's previous action, and raises it again, so
+     the process still terminates, or dumps core, as it would have.
+     A second fatal signal while flushing skips straight to re-raising.
+   - CrashOutput is allocated when a logger enables crash flushing.
+     It holds FdSinks for descriptors the caller has already opened,
+     and a fixed CrashBuffer for formatting records.
+
+   Handlers may only make async-signal-safe calls, so crash flushing
+   never allocates, takes locks, or touches iostreams.  It formats with
+   std::to_chars into CrashBuffer, which truncates rather than grow,
+   and writes with write(2), see FdSink.
+
+   On POSIX the handler runs on a 64 KB alternate stack, so stack
+   overflows are flushed too, but only for faults on the thread that
+   first registered a client.  Other threads use their own stacks.
+
+   Dependencies:
+  ---------------
+   CrashFlush.h
+   LogSinks.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <string_view>
+#include <csignal>
+#include <cstring>
+#include "LogSinks.h"
+
+namespace Test {
+
+  /////////////////////////////////////////////////////////
+  // CrashBuffer - fixed storage, truncates when full
+
+  class CrashBuffer {
+  public:
+    static constexpr size_t capacity = 4096;
+
+    CrashBuffer& append(const char* p, size_t n) {
+      if (n > capacity - size_)
+        n = capacity - size_;
+      std::memcpy(buf_ + size_, p, n);
+      size_ += n;
+      return *this;
+    }
+    CrashBuffer& append(std::string_view text) {
+      return append(text.data(), text.size());
+    }
+    CrashBuffer& operator+=(char ch) {
+      return append(&ch, 1);
+    }
+    CrashBuffer& operator+=(const char* pText) {
+      return append(pText, std::strlen(pText));
+    }
+    CrashBuffer& operator+=(std::string_view text) {
+      return append(text);
+    }
+    const char* data() const { return buf_; }
+    size_t size() const { return size_; }
+    void clear() { size_ = 0; }
+  private:
+    char buf_[capacity];
+    size_t size_ = 0;
+  };
+
+  /////////////////////////////////////////////////////////
+  // CrashOutput - preallocated destination of a crash flush
+
+  class CrashOutput {
+  public:
+    explicit CrashOutput(const std::vector<int>& fds) {
+      for (int fd : fds)
+        sinks_.push_back(std::make_unique<FdSink>(fd));
+    }
+    CrashBuffer& buffer() { return buffer_; }
+    /*-- write data to every descriptor --*/
+    void write(std::string_view data) {
+      for (auto& pSink : sinks_)
+        pSink->write(data);
+    }
+    /*-- write and empty buffer --*/
+    void flush() {
+      write(std::string_view(buffer_.data(), buffer_.size()));
+      buffer_.clear();
+    }
+  private:
+    std::vector<std::unique_ptr<FdSink>> sinks_;
+    CrashBuffer buffer_;
+  };
+
+  /////////////////////////////////////////////////////////
+  // ICrashFlush interface
+  // - crashFlush runs inside a signal handler, so it may
+  //   only make async-signal-safe calls
+
+  struct ICrashFlush {
+    virtual ~ICrashFlush() {}
+    virtual void crashFlush(int signal) noexcept = 0;
+  };
+
+  /////////////////////////////////////////////////////////
+  // CrashHandler - process-wide fatal signal handler
+
+  class CrashHandler {
+  public:
+    static constexpr size_t maxClients = 16;
+
+    /*-- register client, installing handlers the first time --*/
+    static bool add(ICrashFlush* pClient) {
+      std::lock_guard<std::mutex> l(mtx_);
+      install();
+      for (auto& slot : clients_) {
+        if (slot.load() == pClient)
+          return true;
+      }
+      for (auto& slot : clients_) {
+        if (slot.load() == nullptr) {
+          slot.store(pClient);
+          return true;
+        }
+      }
+      return false;
+    }
+    /*-- deregister client, handlers stay installed --*/
+    static void remove(ICrashFlush* pClient) {
+      std::lock_guard<std::mutex> l(mtx_);
+      for (auto& slot : clients_) {
+        if (slot.load() == pClient)
+          slot.store(nullptr);
+      }
+    }
+  private:
+#ifdef SIGBUS
+    static constexpr std::array<int, 4> signals_{ SIGSEGV, SIGABRT, SIGBUS, SIGFPE };
+#else
+    static constexpr std::array<int, 3> signals_{ SIGSEGV, SIGABRT, SIGFPE };
+#endif
+#ifdef _WIN32
+    using Action = void(*)(int);
+#else
+    using Action = struct sigaction;
+    static inline char altStack_[64 * 1024];
+#endif
+    static inline std::array<std::atomic<ICrashFlush*>, maxClients> clients_{};
+    static inline std::array<Action, signals_.size()> previous_{};
+    static inline std::atomic<bool> flushing_{ false };
+    static inline bool installed_ = false;
+    static inline std::mutex mtx_;
+
+    static void install();
+    static void handler(int sig);
+  };
+
+  /*-----------------------------------------------------
+    install handler for each fatal signal, saving the
+    previous actions, caller holds mtx_
+  */
+  inline void CrashHandler::install() {
+    if (installed_)
+      return;
+    installed_ = true;
+#ifdef _WIN32
+    for (size_t i = 0; i < signals_.size(); ++i)
+      previous_[i] = std::signal(signals_[i], handler);
+#else
+    stack_t current;
+    if (sigaltstack(nullptr, &current) == 0 && (current.ss_flags & SS_DISABLE)) {
+      stack_t alt{};
+      alt.ss_sp = altStack_;
+      alt.ss_size = sizeof(altStack_);
+      sigaltstack(&alt, nullptr);
+    }
+    struct sigaction action{};
+    action.sa_handler = handler;
+    action.sa_flags = SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    for (size_t i = 0; i < signals_.size(); ++i)
+      sigaction(signals_[i], &action, &previous_[i]);
+#endif
+  }
+  /*-----------------------------------------------------
+    flush every client, then restore previous action and
+    raise sig again
+  */
+  inline void CrashHandler::handler(int sig) {
+    if (!flushing_.exchange(true)) {
+      for (auto& slot : clients_) {
+        ICrashFlush* pClient = slot.load();
+        if (pClient != nullptr)
+          pClient->crashFlush(sig);
+      }
+    }
+    for (size_t i = 0; i < signals_.size(); ++i) {
+      if (signals_[i] != sig)
+        continue;
+#ifdef _WIN32
+      std::signal(sig, previous_[i]);
+#else
+      sigaction(sig, &previous_[i], nullptr);
+#endif
+    }
+    std::raise(sig);
+  }
+}
@@ -0,0 +1,443 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// DeferredLog.h - Deferred-formatting binary log records              //
+// ver 1.4                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Supports posting without formatting on the caller's thread:
+   - registerFormat(fmt) assigns a FormatId to a static format string,
+     once per call site.  Format strings use {} for each argument.
+   - encodeArgs(record, args...) copies raw argument bytes into a
+     fixed-size DeferredRecord: integers, floating point, bool, char,
+     and anything convertible to std::string_view, copied inline.
+   - appendFormatted(out, record) expands a record into text.
+   - appendBinaryFrame(out, record, ...) appends a record to a binary
+     log, preceded by its format string the first time that format is
+     seen.  appendRecordFrame(out, record) and appendFormatFrame(out,
+     id, fmt) append the two frames separately, for logs that add
+     format frames elsewhere, see StructuredLog.h.  decodeBinaryLog(in, out) expands such a log
+     offline.
+
+   Binary log layout, native byte order:
+     'F' uint32 formatId, uint32 length, format chars
+     'R' uint16 size, DeferredRecord header and size bytes of args
+
+   Dependencies:
+  ---------------
+   DeferredLog.h
+   CallSite.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.4 : 16 Oct 2026
+   - decoding checks every argument against the record's size, and
+     readFormatFrame and readRecordFrame check frame sizes
+   - TEST_POST_DEFERRED honors TESTLOGGER_COMPILED_LEVELS
+   ver 1.3 : 16 Oct 2026
+   - TEST_POST_DEFERRED registers a CallSite, see CallSite.h
+   ver 1.2 : 16 Oct 2026
+   - appendFormatted takes any output buffer, so crash handlers can
+     format into fixed storage, see CrashFlush.h
+   ver 1.1 : 16 Oct 2026
+   - added appendRecordFrame and appendFormatFrame
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include <charconv>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "CallSite.h"
+
+namespace Test {
+
+  using FormatId = uint32_t;
+
+  /////////////////////////////////////////////////////////
+  // FormatRegistry
+  // - fixed table, so writer lookups need no lock
+  // - format strings must outlive the process' logging,
+  //   normally they are string literals
+
+  class FormatRegistry {
+  public:
+    static constexpr size_t maxFormats = 4096;
+    static constexpr FormatId invalidId = UINT32_MAX;
+
+    FormatId add(const char* fmt) {
+      std::lock_guard<std::mutex> l(mtx_);
+      size_t id = count_.load(std::memory_order_relaxed);
+      if (id >= maxFormats)
+        return invalidId;
+      formats_[id].store(fmt, std::memory_order_relaxed);
+      count_.store(id + 1, std::memory_order_release);
+      return static_cast<FormatId>(id);
+    }
+    const char* find(FormatId id) const {
+      if (id >= count_.load(std::memory_order_acquire))
+        return nullptr;
+      return formats_[id].load(std::memory_order_relaxed);
+    }
+  private:
+    std::array<std::atomic<const char*>, maxFormats> formats_{};
+    std::atomic<size_t> count_{ 0 };
+    std::mutex mtx_;
+  };
+
+  inline FormatRegistry& formatRegistry() {
+    static FormatRegistry registry;
+    return registry;
+  }
+
+  inline FormatId registerFormat(const char* fmt) {
+    return formatRegistry().add(fmt);
+  }
+
+  /////////////////////////////////////////////////////////
+  // DeferredRecord
+  // - trivially copyable, 128 bytes
+  // - args holds tagged argument bytes, see encodeArg
+
+  struct DeferredRecord {
+    static constexpr size_t capacity = 120;
+    FormatId formatId = FormatRegistry::invalidId;
+    uint16_t size = 0;
+    uint8_t truncated = 0;
+    uint8_t reserved = 0;
+    char args[capacity];
+  };
+
+  /*-- copy raw bytes, marking record truncated if they don't fit --*/
+  inline bool appendBytes(DeferredRecord& r, const void* p, size_t n) {
+    if (r.size + n > DeferredRecord::capacity) {
+      r.truncated = 1;
+      return false;
+    }
+    std::memcpy(r.args + r.size, p, n);
+    r.size += static_cast<uint16_t>(n);
+    return true;
+  }
+
+  template<typename T>
+  inline void appendTagged(DeferredRecord& r, char tag, T value) {
+    if (r.size + 1 + sizeof(T) > DeferredRecord::capacity) {
+      r.truncated = 1;
+      return;
+    }
+    appendBytes(r, &tag, 1);
+    appendBytes(r, &value, sizeof(T));
+  }
+
+  template<typename T>
+  struct dependent_false : std::false_type {};
+
+  /*-----------------------------------------------------
+    encode one argument
+    - tags: b bool, c char, i int64, u uint64, d double,
+            s uint16 length followed by chars
+    - strings longer than the remaining space are cut
+  */
+  template<typename T>
+  inline void encodeArg(DeferredRecord& r, const T& value) {
+    using U = std::decay_t<T>;
+    if (r.truncated)
+      return;
+    if constexpr (std::is_same_v<U, bool>) {
+      appendTagged(r, 'b', static_cast<uint8_t>(value));
+    }
+    else if constexpr (std::is_same_v<U, char>) {
+      appendTagged(r, 'c', value);
+    }
+    else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+      appendTagged(r, 'i', static_cast<int64_t>(value));
+    }
+    else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>) {
+      appendTagged(r, 'u', static_cast<uint64_t>(value));
+    }
+    else if constexpr (std::is_floating_point_v<U>) {
+      appendTagged(r, 'd', static_cast<double>(value));
+    }
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+      std::string_view sv(value);
+      size_t header = 1 + sizeof(uint16_t);
+      if (r.size + header > DeferredRecord::capacity) {
+        r.truncated = 1;
+        return;
+      }
+      size_t room = DeferredRecord::capacity - r.size - header;
+      uint16_t len = static_cast<uint16_t>(sv.size() < room ? sv.size() : room);
+      char tag = 's';
+      appendBytes(r, &tag, 1);
+      appendBytes(r, &len, sizeof(len));
+      appendBytes(r, sv.data(), len);
+      if (len < sv.size())
+        r.truncated = 1;
+    }
+    else {
+      static_assert(dependent_false<U>::value, "unsupported deferred log argument type");
+    }
+  }
+
+  template<typename... Args>
+  inline void encodeArgs(DeferredRecord& r, FormatId id, const Args&... args) {
+    r.formatId = id;
+    r.size = 0;
+    r.truncated = 0;
+    (encodeArg(r, args), ...);
+  }
+
+  /*-----------------------------------------------------
+    copy n argument bytes at pos to p
+    - returns false, moving pos to the end, if they run
+      past r.size, e.g., in a corrupt binary log
+  */
+  inline bool readArgBytes(const DeferredRecord& r, size_t& pos, void* p, size_t n) {
+    if (r.size > DeferredRecord::capacity || pos + n > r.size) {
+      pos = r.size;
+      return false;
+    }
+    std::memcpy(p, r.args + pos, n);
+    pos += n;
+    return true;
+  }
+
+  /*-----------------------------------------------------
+    decode one argument at pos, appending its text to out
+    - Out is std::string or any buffer with append(p, n)
+      and operator+= for char and C strings
+    - returns false at the end of the arguments, or if an
+      argument runs past r.size
+  */
+  template<typename Out>
+  inline bool appendArg(Out& out, const DeferredRecord& r, size_t& pos) {
+    char tag;
+    if (!readArgBytes(r, pos, &tag, 1))
+      return false;
+    char buf[32];
+    std::to_chars_result res{ buf, std::errc() };
+    switch (tag) {
+    case 'b': {
+      uint8_t v;
+      if (!readArgBytes(r, pos, &v, sizeof(v)))
+        return false;
+      out += v ? "true" : "false";
+      return true;
+    }
+    case 'c': {
+      char v;
+      if (!readArgBytes(r, pos, &v, sizeof(v)))
+        return false;
+      out += v;
+      return true;
+    }
+    case 'i': {
+      int64_t v;
+      if (!readArgBytes(r, pos, &v, sizeof(v)))
+        return false;
+      res = std::to_chars(buf, buf + sizeof(buf), v);
+      break;
+    }
+    case 'u': {
+      uint64_t v;
+      if (!readArgBytes(r, pos, &v, sizeof(v)))
+        return false;
+      res = std::to_chars(buf, buf + sizeof(buf), v);
+      break;
+    }
+    case 'd': {
+      double v;
+      if (!readArgBytes(r, pos, &v, sizeof(v)))
+        return false;
+      res = std::to_chars(buf, buf + sizeof(buf), v);
+      break;
+    }
+    case 's': {
+      uint16_t len;
+      if (!readArgBytes(r, pos, &len, sizeof(len)))
+        return false;
+      if (pos + len > r.size) {
+        pos = r.size;
+        return false;
+      }
+      out.append(r.args + pos, len);
+      pos += len;
+      return true;
+    }
+    default:
+      pos = r.size;
+      return false;
+    }
+    out.append(buf, static_cast<size_t>(res.ptr - buf));
+    return true;
+  }
+
+  /*-- expand record's format string and arguments into out --*/
+  template<typename Out>
+  inline void appendFormatted(Out& out, const char* fmt, const DeferredRecord& r) {
+    if (fmt == nullptr) {
+      char buf[16];
+      auto res = std::to_chars(buf, buf + sizeof(buf), r.formatId);
+      out += "<unknown format ";
+      out.append(buf, static_cast<size_t>(res.ptr - buf));
+      out += ">";
+      return;
+    }
+    size_t pos = 0;
+    for (const char* p = fmt; *p != '\0'; ++p) {
+      if (p[0] == '{' && p[1] == '}') {
+        if (!appendArg(out, r, pos))
+          out += "{?}";
+        ++p;
+      }
+      else {
+        out += *p;
+      }
+    }
+    if (r.truncated)
+      out += " <truncated>";
+  }
+
+  template<typename Out>
+  inline void appendFormatted(Out& out, const DeferredRecord& r) {
+    appendFormatted(out, formatRegistry().find(r.formatId), r);
+  }
+
+  /*-- append format string frame --*/
+  inline void appendFormatFrame(std::string& out, FormatId id, const char* fmt) {
+    uint32_t len = static_cast<uint32_t>(std::strlen(fmt));
+    out += 'F';
+    out.append(reinterpret_cast<const char*>(&id), sizeof(id));
+    out.append(reinterpret_cast<const char*>(&len), sizeof(len));
+    out.append(fmt, len);
+  }
+  /*-- append record frame, without its format string --*/
+  inline void appendRecordFrame(std::string& out, const DeferredRecord& r) {
+    uint16_t size = r.size;
+    out += 'R';
+    out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.append(reinterpret_cast<const char*>(&r), offsetof(DeferredRecord, args) + size);
+  }
+  /*-----------------------------------------------------
+    append record to binary log buffer
+    - formatsSent tracks which format strings this log
+      already holds, one flag per FormatId
+  */
+  inline void appendBinaryFrame(
+    std::string& out, const DeferredRecord& r, std::vector<bool>& formatsSent
+  ) {
+    if (r.formatId < FormatRegistry::maxFormats) {
+      if (formatsSent.size() <= r.formatId)
+        formatsSent.resize(r.formatId + 1, false);
+      if (!formatsSent[r.formatId]) {
+        const char* fmt = formatRegistry().find(r.formatId);
+        if (fmt != nullptr) {
+          appendFormatFrame(out, r.formatId, fmt);
+          formatsSent[r.formatId] = true;
+        }
+      }
+    }
+    appendRecordFrame(out, r);
+  }
+
+  /*-----------------------------------------------------
+    read body of an 'F' frame, its tag already read, into
+    formats[id]
+    - returns false if the frame is corrupt or truncated
+  */
+  inline bool readFormatFrame(std::istream& in, std::vector<std::string>& formats) {
+    static constexpr uint32_t maxLength = 65536;
+    FormatId id;
+    uint32_t len;
+    in.read(reinterpret_cast<char*>(&id), sizeof(id));
+    in.read(reinterpret_cast<char*>(&len), sizeof(len));
+    if (!in || id >= FormatRegistry::maxFormats || len > maxLength)
+      return false;
+    if (formats.size() <= id)
+      formats.resize(id + 1);
+    formats[id].resize(len);
+    in.read(formats[id].data(), len);
+    return static_cast<bool>(in);
+  }
+  /*-----------------------------------------------------
+    read body of an 'R' frame, its tag already read, into r
+    - r.size is the frame's checked size, not the copy
+      inside the record, so decoding stays within r.args
+    - returns false if the frame is corrupt or truncated
+  */
+  inline bool readRecordFrame(std::istream& in, DeferredRecord& r) {
+    uint16_t size;
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!in || size > DeferredRecord::capacity)
+      return false;
+    in.read(reinterpret_cast<char*>(&r), offsetof(DeferredRecord, args) + size);
+    r.size = size;
+    return static_cast<bool>(in);
+  }
+
+  /*-----------------------------------------------------
+    expand binary log from in, writing one line per
+    record to out, prefixed by prefix
+    - returns number of records decoded
+  */
+  inline size_t decodeBinaryLog(std::istream& in, std::ostream& out, const std::string& prefix = "\n  ") {
+    std::vector<std::string> formats;
+    std::string line;
+    size_t count = 0;
+    char tag;
+    while (in.get(tag)) {
+      if (tag == 'F') {
+        if (!readFormatFrame(in, formats))
+          break;
+      }
+      else if (tag == 'R') {
+        DeferredRecord r;
+        if (!readRecordFrame(in, r))
+          break;
+        const char* fmt = r.formatId < formats.size() ? formats[r.formatId].c_str() : nullptr;
+        line = prefix;
+        appendFormatted(line, fmt, r);
+        out << line;
+        ++count;
+      }
+      else {
+        out << prefix << "<corrupt binary log>";
+        break;
+      }
+    }
+    return count;
+  }
+}
+
+/*---------------------------------------------------------------
+  Post format string and arguments without formatting them.
+  - fmt must be a string literal, registered once per call site,
+    along with the site's CallSite, see CallSite.h
+  - requires at least one argument, use post(msg) otherwise
+  - a disabled site skips the post, its location is never shown
+  - compiled out, arguments unevaluated, for levels not in
+    TESTLOGGER_COMPILED_LEVELS, like TEST_POST
+*/
+#define TEST_POST_DEFERRED(logger, fmt, ...) \
+  do { \
+    using TestLoggerType_ = std::decay_t<decltype(logger)>; \
+    if constexpr (Test::isCompiledIn<TestLoggerType_::level_>) { \
+      static const Test::FormatId testLoggerFmtId_ = Test::registerFormat(fmt); \
+      static Test::CallSite testLoggerSite_(__FILE__, __LINE__, __func__, TestLoggerType_::level_, fmt); \
+      if (testLoggerSite_.enabled()) { \
+        testLoggerSite_.hit(); \
+        (logger).postDeferred(testLoggerFmtId_, __VA_ARGS__); \
+      } \
+    } \
+  } while (0)
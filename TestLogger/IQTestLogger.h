@@ -1,13 +1,17 @@
 #pragma once
 /////////////////////////////////////////////////////////////////////////
 // IQTestLogger.h - Queued Logger interface                            //
-// ver 1.1                                                             //
+// ver 1.6                                                             //
 // Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
 /////////////////////////////////////////////////////////////////////////
 
 #include <iostream>
 #include <string>
+#include <cstdint>
+#include <vector>
 #include "ITestLogger.h"
+#include "LoggerStats.h"
+#include "PriorityLanes.h"
 
 ///////////////////////////////////////////////////////////
 // IQTestLogger<T>
@@ -15,13 +19,38 @@
 
 namespace Test {
 
+  /*-----------------------------------------------------
+    What a bounded QTestLogger does with a post that
+    doesn't fit, see QTestLogger::setCapacity
+  */
+  enum class Overflow {
+    block, dropNewest, overwriteOldest, dropBelowLevel
+  };
+
   template<Level L>
   struct IQTestLogger : virtual public ITestLogger<L> {
     virtual ~IQTestLogger() {};
     virtual void wait() = 0;
+    virtual size_t ticket() = 0;
+    virtual bool waitFor(size_t ticket, size_t timeoutMillisecs = SIZE_MAX) = 0;
     virtual void start() = 0;
     virtual void stop() = 0;
     virtual double elapsedMicroseconds() = 0;
+    virtual void setBatching(size_t maxBatch, size_t lingerMicrosecs = 0) = 0;
+    virtual void setCoalescing(bool on, size_t flushMillisecs = 1000) = 0;
+    virtual void setDurability(Durability durability, size_t commitMicrosecs = 500) = 0;
+    virtual Durability durability() = 0;
+    virtual void setLanes(Drain drain, size_t syncDepth = 0, size_t weight = 4) = 0;
+    virtual void setCapacity(
+      size_t maxMessages, size_t maxBytes = 0,
+      Overflow policy = Overflow::block, Level keepLevel = Level::results
+    ) = 0;
+    virtual size_t dropped(Level l) = 0;
+    virtual size_t dropped() = 0;
+    virtual void setFanOut(bool on, size_t maxLagBytes = 0) = 0;
+    virtual LoggerStats stats() = 0;
+    virtual void enableCrashFlush(const std::vector<int>& fds = { 2 }) = 0;
+    virtual void disableCrashFlush() = 0;
   };
 
   template<Level L = Level::all>
@@ -1,13 +1,58 @@
 #pragma once
 /////////////////////////////////////////////////////////////////////////
 // ITestLogger.h - Logger interface                                    //
-// ver 1.1                                                             //
+// ver 1.5                                                             //
 // Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
 /////////////////////////////////////////////////////////////////////////
 
+/*
+   Level filtering:
+  ------------------
+   - logLevel is a process-wide mask of enabled levels.  Posts check it
+     with one relaxed atomic load before doing any formatting.
+   - TESTLOGGER_COMPILED_LEVELS is a compile-time mask of the levels
+     that are built at all, default 7 = Level::all.  Define it, e.g.,
+     /D TESTLOGGER_COMPILED_LEVELS=1 for results-only release builds.
+     TEST_POST(logger, msg) and TEST_POST_DATED(logger, msg) compile
+     to nothing for loggers whose level is not in that mask, and never
+     evaluate msg unless the post will be written.
+
+   Call sites:
+  -------------
+   - TEST_POST, TEST_POST_DATED, and TEST_POST_DEFERRED register a
+     static CallSite the first time each runs, see CallSite.h.  Sites
+     can be disabled at run time by pattern, disabled sites cost one
+     branch, and enabled sites count their posts, so the noisiest can
+     be listed with callSites().showTop(out, n).
+   - TEST_POST_EVERY_N(logger, n, msg), TEST_POST_RATE(logger, k, msg),
+     and TEST_POST_FIRST_N(logger, n, every, msg) also give their site
+     a SiteLimiter, see SiteLimiter.h, which samples or rate limits it
+     before msg is evaluated.  Suppressed occurrences are reported by
+     a "suppressed N occurrences" line at most once a second, and
+     any still unreported by postPendingSummaries(logger), which
+     QTestLogger calls in wait() and when destroyed.
+
+   Structured posts:
+  -------------------
+   - post(FieldRecord) and postDated(FieldRecord) log typed key-value
+     fields, see StructuredLog.h.  addStream and addSink take the
+     SinkFormat each stream is rendered in, text by default.
+*/
+
 #include <iostream>
 #include <string>
 #include <memory>
+#include <atomic>
+#include <type_traits>
+#include "LogSinks.h"
+#include "MessageBuilder.h"
+#include "StructuredLog.h"
+#include "CallSite.h"
+#include "SiteLimiter.h"
+
+#ifndef TESTLOGGER_COMPILED_LEVELS
+#define TESTLOGGER_COMPILED_LEVELS 7
+#endif
 
 namespace Test {
 
@@ -15,10 +60,13 @@ namespace Test {
     results = 1, demo = 2, debug = 4, all = 7 
   };
 
-  inline size_t levelValue(Level l) { 
+  constexpr size_t levelValue(Level l) { 
     return static_cast<size_t>(l); 
   }
 
+  template<Level L>
+  constexpr bool isCompiledIn = (levelValue(L) & TESTLOGGER_COMPILED_LEVELS) != 0;
+
   inline std::string levelType(Level l) {
     switch (l) {
     case Level::all:
@@ -34,25 +82,157 @@ namespace Test {
     }
   }
 
-  Level logLevel = Level::all;
+  /////////////////////////////////////////////////////////
+  // LevelMask - runtime level filter shared by all threads
+  // - assigns from and converts to Level, so logLevel reads
+  //   and writes like the Level it replaces
+
+  class LevelMask {
+  public:
+    LevelMask(Level l) : mask_(levelValue(l)) {}
+    LevelMask(const LevelMask&) = delete;
+    LevelMask& operator=(const LevelMask&) = delete;
+    LevelMask& operator=(Level l) {
+      mask_.store(levelValue(l), std::memory_order_relaxed);
+      return *this;
+    }
+    operator Level() const {
+      return static_cast<Level>(mask_.load(std::memory_order_relaxed));
+    }
+    bool enabled(Level l) const {
+      return (mask_.load(std::memory_order_relaxed) & levelValue(l)) != 0;
+    }
+  private:
+    std::atomic<size_t> mask_;
+  };
+
+  inline LevelMask logLevel(Level::all);
 
   template<Level L>
   struct ITestLogger {
+    static constexpr Level level_ = L;
     virtual ~ITestLogger() {}
-    virtual void addStream(std::ostream* pOstream) = 0;
+    virtual void addStream(std::ostream* pOstream, SinkFormat format = SinkFormat::text) = 0;
     virtual bool removeStream(std::ostream* pOstream) = 0;
+    virtual void addSink(ISink* pSink, SinkFormat format = SinkFormat::text) = 0;
+    virtual bool removeSink(ISink* pSink) = 0;
     virtual size_t streamCount() = 0;
     virtual ITestLogger<L>& post(const std::string& msg) = 0;
     virtual ITestLogger<L>& postDated(const std::string& msg) = 0;
+    virtual ITestLogger<L>& post(const MessageBuilder& msg) = 0;
+    virtual ITestLogger<L>& postDated(const MessageBuilder& msg) = 0;
+    virtual ITestLogger<L>& post(const FieldRecord& rec) = 0;
+    virtual ITestLogger<L>& postDated(const FieldRecord& rec) = 0;
     virtual ITestLogger<L>& setPrefix(const std::string& prefix) = 0;
     virtual ITestLogger<L>& setSuffix(const std::string& suffix) = 0;
     virtual void clear() = 0;
     virtual std::string level() = 0;
   };
 
+  /*-----------------------------------------------------
+    post msg from site, prefixed with its location when
+    callSites().showLocation() is on
+  */
+  template<typename Logger, typename Msg>
+  inline void postAtSite(Logger& logger, const CallSite& site, const Msg& msg, bool dated) {
+    if (!callSites().showLocation()) {
+      dated ? logger.postDated(msg) : logger.post(msg);
+      return;
+    }
+    if constexpr (std::is_same_v<Msg, FieldRecord>) {
+      static const KeyId siteKey = registerKey("site");
+      FieldRecord rec(msg);
+      rec.add(siteKey, std::string_view(site.location()));
+      dated ? logger.postDated(rec) : logger.post(rec);
+    }
+    else {
+      MessageBuilder mb;
+      mb << site.location() << "  " << msg;
+      dated ? logger.postDated(mb) : logger.post(mb);
+    }
+  }
+
+  /*-- post count of occurrences site's limiter suppressed --*/
+  template<typename Logger>
+  inline void postSuppressed(Logger& logger, const CallSite& site, uint64_t count) {
+    MessageBuilder mb;
+    mb << site.location() << "  suppressed " << count << " occurrences of " << site.format();
+    logger.post(mb);
+  }
+
+  /*-- identity of logger, the same whatever interface it is reached through --*/
+  template<Level L>
+  inline const void* loggerKey(const ITestLogger<L>& logger) {
+    return &logger;
+  }
+
+  /*-- post occurrences suppressed by sites that last posted to logger, not yet reported --*/
+  template<Level L>
+  inline void postPendingSummaries(ITestLogger<L>& logger) {
+    for (auto& pending : siteLimiters().takePending(loggerKey<L>(logger)))
+      postSuppressed(logger, *pending.first, pending.second);
+  }
+
   template<Level L = Level::all>
   inline std::unique_ptr<ITestLogger<L>> createLogger(std::ostream* pStrm = &std::cout);
 
   template<size_t N = 0, Level L = Level::all>
   inline ITestLogger<L>& getSingletonLogger(std::ostream* pStrm = &std::cout);
-}
\ No newline at end of file
+}
+
+/*---------------------------------------------------------------
+  Post only if logger's level is compiled in and enabled, and the
+  call site is enabled, see CallSite.h.
+  - msg is not evaluated when the post is filtered out
+  - logger is an object or reference, use *pLogger for pointers
+*/
+#define TEST_POST_AT_SITE_(logger, msg, dated) \
+  do { \
+    using TestLoggerType_ = std::decay_t<decltype(logger)>; \
+    if constexpr (Test::isCompiledIn<TestLoggerType_::level_>) { \
+      static Test::CallSite testLoggerSite_(__FILE__, __LINE__, __func__, TestLoggerType_::level_, #msg); \
+      if (testLoggerSite_.enabled() && Test::logLevel.enabled(TestLoggerType_::level_)) { \
+        testLoggerSite_.hit(); \
+        Test::postAtSite(logger, testLoggerSite_, msg, dated); \
+      } \
+    } \
+  } while (0)
+
+#define TEST_POST(logger, msg) TEST_POST_AT_SITE_(logger, msg, false)
+
+#define TEST_POST_DATED(logger, msg) TEST_POST_AT_SITE_(logger, msg, true)
+
+/*---------------------------------------------------------------
+  Post as TEST_POST does, if the site's SiteLimiter admits this
+  occurrence, see SiteLimiter.h.
+  - suppressed occurrences never evaluate msg or touch the queue
+  - any occurrence first reports suppressed occurrences, if the
+    last report was long enough ago
+*/
+#define TEST_POST_LIMITED_(logger, limit, msg, dated) \
+  do { \
+    using TestLoggerType_ = std::decay_t<decltype(logger)>; \
+    if constexpr (Test::isCompiledIn<TestLoggerType_::level_>) { \
+      static Test::CallSite testLoggerSite_(__FILE__, __LINE__, __func__, TestLoggerType_::level_, #msg); \
+      static Test::SiteLimiter testLoggerLimiter_(limit, &testLoggerSite_); \
+      if (testLoggerSite_.enabled() && Test::logLevel.enabled(TestLoggerType_::level_)) { \
+        bool testLoggerAdmitted_ = testLoggerLimiter_.admit(); \
+        if (uint64_t testLoggerSuppressed_ = testLoggerLimiter_.takeSummary( \
+          testLoggerAdmitted_, Test::loggerKey<TestLoggerType_::level_>(logger))) \
+          Test::postSuppressed(logger, testLoggerSite_, testLoggerSuppressed_); \
+        if (testLoggerAdmitted_) { \
+          testLoggerSite_.hit(); \
+          Test::postAtSite(logger, testLoggerSite_, msg, dated); \
+        } \
+      } \
+    } \
+  } while (0)
+
+#define TEST_POST_EVERY_N(logger, n, msg) \
+  TEST_POST_LIMITED_(logger, Test::Limit::everyN(n), msg, false)
+
+#define TEST_POST_RATE(logger, k, msg) \
+  TEST_POST_LIMITED_(logger, Test::Limit::perSecond(k), msg, false)
+
+#define TEST_POST_FIRST_N(logger, n, every, msg) \
+  TEST_POST_LIMITED_(logger, Test::Limit::firstN(n, every), msg, false)
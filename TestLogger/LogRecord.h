@@ -0,0 +1,231 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// LogRecord.h - Fixed-capacity log message text                       //
+// ver 1.2                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   LogRecord holds one formatted log message:
+   - text shorter than inlineCapacity chars lives inside the record,
+     so building a typical message and moving it through a write queue
+     never touches the heap
+   - the text is always followed by a null, not counted in size(), so
+     c_str() is a plain read
+   - longer text spills to a buffer taken from SpillPool.  Moving a
+     spilled record hands over its buffer, and destroying it returns
+     the buffer to the pool, so steady state logging of long messages
+     doesn't allocate either.
+   - the record is 256 bytes, four cache lines
+
+   SpillPool keeps freed buffers in power of two size classes, from
+   minSpill up to maxSpill, retaining at most maxPooledBytes per class.
+   Larger buffers go straight to the heap.
+
+   Dependencies:
+  ---------------
+   LogRecord.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.2 : 16 Oct 2026
+   - text is always null terminated, replacing terminate() with c_str()
+   ver 1.1 : 16 Oct 2026
+   - added terminate(), for LogMessage::c_str()
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <mutex>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+namespace Test {
+
+  /////////////////////////////////////////////////////////
+  // SpillPool
+  // - shared by all threads, records are usually built on
+  //   posting threads and destroyed on the write thread
+
+  class SpillPool {
+  public:
+    static constexpr size_t minSpill = 512;
+    static constexpr size_t maxSpill = 64 * 1024;
+    static constexpr size_t maxPooledBytes = 1024 * 1024;
+
+    char* acquire(size_t minSize, size_t& capacity) {
+      size_t cls = sizeClass(minSize);
+      if (cls == classCount) {
+        capacity = minSize;
+        return new char[minSize];
+      }
+      capacity = minSpill << cls;
+      {
+        std::lock_guard<std::mutex> l(mtx_);
+        auto& free = free_[cls];
+        if (!free.empty()) {
+          char* pBuf = free.back();
+          free.pop_back();
+          return pBuf;
+        }
+      }
+      return new char[capacity];
+    }
+    void release(char* pBuf, size_t capacity) {
+      size_t cls = sizeClass(capacity);
+      if (cls < classCount) {
+        std::lock_guard<std::mutex> l(mtx_);
+        auto& free = free_[cls];
+        if ((free.size() + 1) * capacity <= maxPooledBytes) {
+          free.push_back(pBuf);
+          return;
+        }
+      }
+      delete[] pBuf;
+    }
+  private:
+    static constexpr size_t classCount = 8;  // 512 B ... 64 KB
+
+    static size_t sizeClass(size_t size) {
+      size_t cls = 0;
+      while (cls < classCount && (minSpill << cls) < size)
+        ++cls;
+      return cls;
+    }
+    std::array<std::vector<char*>, classCount> free_;
+    std::mutex mtx_;
+  };
+
+  /*-- never destroyed, static loggers may free records during exit --*/
+  inline SpillPool& spillPool() {
+    static SpillPool* pPool = new SpillPool;
+    return *pPool;
+  }
+
+  /////////////////////////////////////////////////////////
+  // LogRecord
+  // - append-only text buffer with inline storage
+  // - moves copy only the bytes in use
+  // - capacity counts the null, so holds capacity - 1 chars
+
+  class LogRecord {
+  public:
+    static constexpr size_t inlineCapacity = 240;
+
+    LogRecord() {
+      inline_[0] = '\0';
+    }
+    LogRecord(std::string_view text) {
+      append(text);
+    }
+    LogRecord(const LogRecord& rec) {
+      append(rec.view());
+    }
+    LogRecord(LogRecord&& rec) noexcept {
+      take(rec);
+    }
+    LogRecord& operator=(const LogRecord& rec) {
+      if (this != &rec) {
+        clear();
+        append(rec.view());
+      }
+      return *this;
+    }
+    LogRecord& operator=(LogRecord&& rec) noexcept {
+      if (this != &rec) {
+        freeSpill();
+        take(rec);
+      }
+      return *this;
+    }
+    ~LogRecord() {
+      freeSpill();
+    }
+
+    const char* data() const { return pSpill_ != nullptr ? pSpill_ : inline_; }
+    const char* c_str() const { return data(); }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+    bool spilled() const { return pSpill_ != nullptr; }
+    std::string_view view() const { return std::string_view(data(), size_); }
+    operator std::string_view() const { return view(); }
+
+    /*-- discard text, keeping any spill buffer for reuse --*/
+    void clear() {
+      size_ = 0;
+      buffer()[0] = '\0';
+    }
+    /*-- make room for size chars and a null, spilling if they won't fit inline --*/
+    void reserve(size_t size) {
+      if (size < capacity_)
+        return;
+      size_t capacity;
+      char* pBuf = spillPool().acquire(size + 1, capacity);
+      std::memcpy(pBuf, data(), size_ + 1);
+      freeSpill();
+      pSpill_ = pBuf;
+      capacity_ = static_cast<uint32_t>(capacity);
+    }
+    LogRecord& append(const char* pText, size_t count) {
+      if (size_ + count >= capacity_)
+        reserve(size_ + count >= 2 * capacity_ ? size_ + count : 2 * capacity_ - 1);
+      std::memcpy(buffer() + size_, pText, count);
+      size_ += static_cast<uint32_t>(count);
+      buffer()[size_] = '\0';
+      return *this;
+    }
+    LogRecord& append(std::string_view text) {
+      return append(text.data(), text.size());
+    }
+    LogRecord& append(const std::string& text) {
+      return append(text.data(), text.size());
+    }
+    LogRecord& append(const char* pText) {
+      return append(pText, std::strlen(pText));
+    }
+    LogRecord& operator+=(std::string_view text) {
+      return append(text);
+    }
+    std::string toString() const {
+      return std::string(data(), size_);
+    }
+  private:
+    char* buffer() { return pSpill_ != nullptr ? pSpill_ : inline_; }
+    void take(LogRecord& rec) {
+      size_ = rec.size_;
+      if (rec.pSpill_ != nullptr) {
+        pSpill_ = rec.pSpill_;
+        capacity_ = rec.capacity_;
+        rec.pSpill_ = nullptr;
+        rec.capacity_ = inlineCapacity;
+      }
+      else {
+        pSpill_ = nullptr;
+        capacity_ = inlineCapacity;
+        std::memcpy(inline_, rec.inline_, size_ + 1);
+      }
+      rec.size_ = 0;
+      rec.inline_[0] = '\0';
+    }
+    void freeSpill() {
+      if (pSpill_ != nullptr) {
+        spillPool().release(pSpill_, capacity_);
+        pSpill_ = nullptr;
+        capacity_ = inlineCapacity;
+      }
+    }
+    char* pSpill_ = nullptr;
+    uint32_t size_ = 0;
+    uint32_t capacity_ = inlineCapacity;
+    char inline_[inlineCapacity];
+  };
+
+  static_assert(sizeof(LogRecord) == 256, "LogRecord should fill four cache lines");
+}
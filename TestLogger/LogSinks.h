@@ -0,0 +1,261 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// LogSinks.h - Native log sinks, bypassing std::ostream               //
+// ver 1.3                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   ISink is the loggers' output interface:
+   - write(data) writes a whole buffer, typically a batch of formatted
+     messages, and returns false if it couldn't
+   - flush() pushes buffered output on, close() releases the output
+   - sync() flushes, then, if it can, waits until the output is on
+     stable storage, returning true if it did.  Only FdSink can, with
+     fdatasync, or _commit on Windows.  Streams can only be flushed,
+     so records that must survive a power loss need an FdSink.
+   - canSync() says whether sync() can reach stable storage, so a
+     logger waits to share a commit only when one will happen.
+   Loggers serialize calls on each sink, so sinks need no locking of
+   their own for writes.
+
+   Sinks provided:
+   - FdSink writes straight to a file descriptor with write(2), or
+     _write on Windows, with no iostream sentry, locale, or streambuf
+     calls.  It opens a file by name, owning that descriptor, or wraps
+     an existing one.  stdoutSink() and stderrSink() return shared
+     sinks for descriptors 1 and 2.
+   - MemorySink appends to a std::string, str() returns a copy.
+   - OStreamSink adapts a std::ostream, so addStream(std::ostream*)
+     callers keep working.
+
+   SinkFormat selects how loggers render records for a sink: text,
+   newline-delimited JSON, or the binary log of StructuredLog.h.
+
+   Durability says what must happen to a sink after a record is
+   written, before it counts as written: nothing, flush(), or sync(),
+   see applyDurability.
+
+   Dependencies:
+  ---------------
+   LogSinks.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.3 : 16 Oct 2026
+   - added ISink::canSync
+   ver 1.2 : 16 Oct 2026
+   - added ISink::sync, FdSink::sync, and Durability
+   ver 1.1 : 16 Oct 2026
+   - added SinkFormat
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Test {
+
+  /////////////////////////////////////////////////////////
+  // SinkFormat - rendering of records written to a sink
+
+  enum class SinkFormat : uint8_t { text, json, binary };
+
+  constexpr size_t sinkFormatCount = 3;
+
+  constexpr size_t formatIndex(SinkFormat f) {
+    return static_cast<size_t>(f);
+  }
+
+  constexpr unsigned formatBit(SinkFormat f) {
+    return 1u << static_cast<unsigned>(f);
+  }
+
+  /////////////////////////////////////////////////////////
+  // Durability - how far a written record must get
+
+  enum class Durability : uint8_t { none, flushed, fsynced };
+
+  /////////////////////////////////////////////////////////
+  // ISink interface
+
+  struct ISink {
+    virtual ~ISink() {}
+    virtual bool write(std::string_view data) = 0;
+    virtual void flush() = 0;
+    virtual void close() = 0;
+    /*-- flush, returns true only if output reached stable storage --*/
+    virtual bool sync() {
+      flush();
+      return false;
+    }
+    /*-- can sync() reach stable storage, override with sync() --*/
+    virtual bool canSync() const { return false; }
+  };
+
+  /*-- flush or sync sink as durability requires --*/
+  inline void applyDurability(ISink& sink, Durability durability) {
+    if (durability == Durability::fsynced)
+      sink.sync();
+    else if (durability == Durability::flushed)
+      sink.flush();
+  }
+
+  /////////////////////////////////////////////////////////
+  // FdSink - unbuffered file descriptor output
+
+  class FdSink : public ISink {
+  public:
+    FdSink(int fd, bool owned = false) : fd_(fd), owned_(owned) {}
+    FdSink(const std::string& path, bool append = false);
+    FdSink(const FdSink&) = delete;
+    FdSink& operator=(const FdSink&) = delete;
+    ~FdSink() { close(); }
+    bool isOpen() const { return fd_ >= 0; }
+    int fd() const { return fd_; }
+    virtual bool write(std::string_view data) override;
+    virtual void flush() override {}
+    virtual void close() override;
+    virtual bool sync() override;
+    virtual bool canSync() const override { return fd_ >= 0; }
+  private:
+    int fd_;
+    bool owned_;
+  };
+
+  /*-- open file for writing, owning its descriptor --*/
+  inline FdSink::FdSink(const std::string& path, bool append) : fd_(-1), owned_(true) {
+    int flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+#ifdef _WIN32
+    _sopen_s(&fd_, path.c_str(), flags | O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE);
+#else
+    fd_ = ::open(path.c_str(), flags, 0644);
+#endif
+  }
+  /*-- write all of data, retrying partial and interrupted writes --*/
+  inline bool FdSink::write(std::string_view data) {
+    if (fd_ < 0)
+      return false;
+    const char* pos = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+#ifdef _WIN32
+      unsigned chunk = remaining > INT_MAX ? INT_MAX : static_cast<unsigned>(remaining);
+      int n = _write(fd_, pos, chunk);
+#else
+      ssize_t n = ::write(fd_, pos, remaining);
+#endif
+      if (n < 0) {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+      pos += n;
+      remaining -= static_cast<size_t>(n);
+    }
+    return true;
+  }
+  /*-----------------------------------------------------
+    wait until written data is on stable storage
+    - fdatasync skips metadata a later read doesn't need,
+      macOS only has fsync
+    - fails for pipes and terminals
+  */
+  inline bool FdSink::sync() {
+    if (fd_ < 0)
+      return false;
+#if defined(_WIN32)
+    return _commit(fd_) == 0;
+#elif defined(__APPLE__)
+    return ::fsync(fd_) == 0;
+#else
+    return ::fdatasync(fd_) == 0;
+#endif
+  }
+  /*-- close descriptor if this sink opened it --*/
+  inline void FdSink::close() {
+    if (fd_ >= 0 && owned_) {
+#ifdef _WIN32
+      _close(fd_);
+#else
+      ::close(fd_);
+#endif
+    }
+    fd_ = -1;
+  }
+
+  /*-- process-wide sinks for standard output and error --*/
+  inline FdSink& stdoutSink() {
+    static FdSink sink(1);
+    return sink;
+  }
+  inline FdSink& stderrSink() {
+    static FdSink sink(2);
+    return sink;
+  }
+
+  /////////////////////////////////////////////////////////
+  // MemorySink - collects output in memory
+  // - str() and clear() may be called while a logger writes
+
+  class MemorySink : public ISink {
+  public:
+    virtual bool write(std::string_view data) override {
+      std::lock_guard<std::mutex> l(mtx_);
+      buffer_.append(data.data(), data.size());
+      return true;
+    }
+    virtual void flush() override {}
+    virtual void close() override {}
+    std::string str() {
+      std::lock_guard<std::mutex> l(mtx_);
+      return buffer_;
+    }
+    void clear() {
+      std::lock_guard<std::mutex> l(mtx_);
+      buffer_.clear();
+    }
+  private:
+    std::string buffer_;
+    std::mutex mtx_;
+  };
+
+  /////////////////////////////////////////////////////////
+  // OStreamSink - adapts std::ostream to ISink
+
+  class OStreamSink : public ISink {
+  public:
+    OStreamSink(std::ostream* pStrm) : pStrm_(pStrm) {}
+    std::ostream* stream() const { return pStrm_; }
+    virtual bool write(std::string_view data) override {
+      pStrm_->write(data.data(), static_cast<std::streamsize>(data.size()));
+      return pStrm_->good();
+    }
+    virtual void flush() override {
+      pStrm_->flush();
+    }
+    virtual void close() override {
+      std::ofstream* pFile = dynamic_cast<std::ofstream*>(pStrm_);
+      if (pFile != nullptr)
+        pFile->close();
+    }
+  private:
+    std::ostream* pStrm_;
+  };
+}
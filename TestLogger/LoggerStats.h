@@ -0,0 +1,348 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// LoggerStats.h - Low-overhead logger statistics                      //
+// ver 1.4                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Counters cheap enough to leave on in production:
+   - LatencyHistogram records nanosecond latencies in HDR-style
+     log-linear buckets, 16 per power of two, so any percentile is
+     reported within about 6%, from 1 ns to about 39 hours, in a
+     fixed 720 bucket table.
+   - ThreadCounters gives each posting thread its own count of posts
+     and bytes.  Threads find their slot through a small thread_local
+     cache, backed by a thread_local map from logger id to slot, so
+     posts never touch a shared cache line or take a lock.  A thread
+     gets one slot per logger, however many loggers it posts to in
+     turn.  Map entries of destroyed loggers are pruned the next time
+     the thread meets a new logger.  totals() sums the slots when
+     statistics are read.
+   - WriterCounters holds the write thread's batches, messages, bytes,
+     busy and idle time, queue high-water mark, latency histogram,
+     repeated messages coalesced, and durable group commits.
+   - LoggerStats and SinkStats are the snapshots readers get.  Its
+     synced count, results posts written by their posting threads, is
+     kept by the logger, see QTestLogger::setLanes.
+
+   Every counter has exactly one writing thread, which updates it with
+   a relaxed load and store, not a read-modify-write, so updates are
+   plain memory writes.  Readers use relaxed loads, so a snapshot may
+   mix values from adjacent updates, but never tears one value.
+
+   Dependencies:
+  ---------------
+   LoggerStats.h
+   LogSinks.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.4 : 16 Oct 2026
+   - threads keep a map of their slots, so a cache miss no longer
+     registers another slot
+   ver 1.3 : 16 Oct 2026
+   - added synced counts
+   ver 1.2 : 16 Oct 2026
+   - added commit counts
+   ver 1.1 : 16 Oct 2026
+   - added coalesced message counts
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <iostream>
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "LogSinks.h"
+
+namespace Test {
+
+  /*-- add to a counter only this thread writes --*/
+  inline void bump(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+
+  /*-- steady clock nanoseconds, the time base of latency stamps --*/
+  inline uint64_t steadyNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()
+    ).count());
+  }
+
+  /////////////////////////////////////////////////////////
+  // LatencyHistogram
+  // - one writing thread, see record
+  // - copies take a snapshot
+
+  class LatencyHistogram {
+  public:
+    static constexpr unsigned subBits = 4;
+    static constexpr uint64_t subCount = 1 << subBits;
+    static constexpr unsigned maxExponent = 47;
+    static constexpr size_t bucketCount = (maxExponent - subBits + 2) * subCount;
+
+    LatencyHistogram() {}
+    LatencyHistogram(const LatencyHistogram& h) {
+      *this = h;
+    }
+    LatencyHistogram& operator=(const LatencyHistogram& h) {
+      for (size_t i = 0; i < bucketCount; ++i)
+        buckets_[i].store(h.buckets_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      count_.store(h.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      sum_.store(h.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      max_.store(h.max_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      return *this;
+    }
+
+    /*-- record one latency, called only by the owning thread --*/
+    void record(uint64_t ns) {
+      bump(buckets_[bucketOf(ns)]);
+      bump(count_);
+      bump(sum_, ns);
+      if (ns > max_.load(std::memory_order_relaxed))
+        max_.store(ns, std::memory_order_relaxed);
+    }
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const {
+      uint64_t n = count();
+      return n == 0 ? 0.0 : static_cast<double>(sum_.load(std::memory_order_relaxed)) / n;
+    }
+    /*-- highest value in bucket holding fraction q of samples, 0 <= q <= 1 --*/
+    uint64_t percentile(double q) const {
+      uint64_t n = count();
+      if (n == 0)
+        return 0;
+      uint64_t rank = static_cast<uint64_t>(q * n + 0.5);
+      if (rank < 1)
+        rank = 1;
+      uint64_t seen = 0;
+      for (size_t i = 0; i < bucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+          uint64_t high = highestOf(i);
+          uint64_t top = max();
+          return high < top ? high : top;
+        }
+      }
+      return max();
+    }
+    uint64_t bucketCountAt(size_t i) const {
+      return buckets_[i].load(std::memory_order_relaxed);
+    }
+    static uint64_t lowestOf(size_t i) {
+      if (i < subCount)
+        return i;
+      unsigned e = static_cast<unsigned>(i / subCount) + subBits - 1;
+      return (subCount + i % subCount) << (e - subBits);
+    }
+    static uint64_t highestOf(size_t i) {
+      if (i < subCount)
+        return i;
+      unsigned e = static_cast<unsigned>(i / subCount) + subBits - 1;
+      return lowestOf(i) + (uint64_t(1) << (e - subBits)) - 1;
+    }
+    static size_t bucketOf(uint64_t ns) {
+      if (ns < subCount)
+        return static_cast<size_t>(ns);
+      unsigned e = 63;
+      while ((ns >> e) == 0)
+        --e;
+      if (e > maxExponent)
+        return bucketCount - 1;
+      uint64_t sub = (ns >> (e - subBits)) & (subCount - 1);
+      return static_cast<size_t>((e - subBits + 1) * subCount + sub);
+    }
+  private:
+    std::array<std::atomic<uint64_t>, bucketCount> buckets_{};
+    std::atomic<uint64_t> count_{ 0 };
+    std::atomic<uint64_t> sum_{ 0 };
+    std::atomic<uint64_t> max_{ 0 };
+  };
+
+  /////////////////////////////////////////////////////////
+  // ThreadCounters - per-thread post counts for one logger
+
+  class ThreadCounters {
+  public:
+    struct alignas(64) Slot {
+      std::atomic<uint64_t> posts{ 0 };
+      std::atomic<uint64_t> bytes{ 0 };
+    };
+    struct Totals {
+      uint64_t posts = 0;
+      uint64_t bytes = 0;
+    };
+
+    ThreadCounters() : id_(nextId()) {
+      Registry& r = registry();
+      std::lock_guard<std::mutex> l(r.mtx);
+      r.live.insert(id_);
+    }
+    ~ThreadCounters() {
+      Registry& r = registry();
+      std::lock_guard<std::mutex> l(r.mtx);
+      r.live.erase(id_);
+      r.deaths.fetch_add(1, std::memory_order_release);
+    }
+    ThreadCounters(const ThreadCounters&) = delete;
+    ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+    /*-- count one post of size bytes on the calling thread --*/
+    void add(uint64_t bytes) {
+      Slot& slot = local();
+      bump(slot.posts);
+      bump(slot.bytes, bytes);
+    }
+    Totals totals() {
+      Totals t;
+      std::lock_guard<std::mutex> l(mtx_);
+      for (auto& pSlot : slots_) {
+        t.posts += pSlot->posts.load(std::memory_order_relaxed);
+        t.bytes += pSlot->bytes.load(std::memory_order_relaxed);
+      }
+      return t;
+    }
+  private:
+    static constexpr size_t cacheSize = 8;
+    struct CacheEntry {
+      uint64_t id = 0;
+      Slot* pSlot = nullptr;
+    };
+    /*-- a thread's slots, by logger id --*/
+    struct ThreadSlots {
+      std::array<CacheEntry, cacheSize> cache;
+      size_t nextVictim = 0;
+      std::unordered_map<uint64_t, Slot*> slots;
+      uint64_t deathsSeen = 0;
+    };
+    /*-- ids of live ThreadCounters, and how many have died --*/
+    struct Registry {
+      std::mutex mtx;
+      std::unordered_set<uint64_t> live;
+      std::atomic<uint64_t> deaths{ 0 };
+    };
+
+    static uint64_t nextId() {
+      static std::atomic<uint64_t> id{ 0 };
+      return ++id;
+    }
+    static Registry& registry() {
+      static Registry r;
+      return r;
+    }
+    /*-----------------------------------------------------
+      calling thread's slot
+      - ids are never reused, so a cache entry can't match
+        a later logger built at the same address
+      - a cache miss finds the slot in the thread's map, and
+        only a thread's first post to this logger registers
+        a slot, taking mtx_
+    */
+    Slot& local() {
+      thread_local ThreadSlots mine;
+      for (auto& entry : mine.cache) {
+        if (entry.id == id_)
+          return *entry.pSlot;
+      }
+      Slot* pSlot;
+      auto iter = mine.slots.find(id_);
+      if (iter != mine.slots.end()) {
+        pSlot = iter->second;
+      }
+      else {
+        prune(mine);
+        {
+          std::lock_guard<std::mutex> l(mtx_);
+          slots_.push_back(std::make_unique<Slot>());
+          pSlot = slots_.back().get();
+        }
+        mine.slots.emplace(id_, pSlot);
+      }
+      CacheEntry& entry = mine.cache[mine.nextVictim];
+      mine.nextVictim = (mine.nextVictim + 1) % cacheSize;
+      entry.id = id_;
+      entry.pSlot = pSlot;
+      return *pSlot;
+    }
+    /*-- drop thread's map entries of destroyed loggers, if any died since last time --*/
+    static void prune(ThreadSlots& mine) {
+      Registry& r = registry();
+      if (r.deaths.load(std::memory_order_acquire) == mine.deathsSeen)
+        return;
+      std::lock_guard<std::mutex> l(r.mtx);
+      for (auto iter = mine.slots.begin(); iter != mine.slots.end();) {
+        if (r.live.count(iter->first) == 0)
+          iter = mine.slots.erase(iter);
+        else
+          ++iter;
+      }
+      mine.deathsSeen = r.deaths.load(std::memory_order_relaxed);
+    }
+    uint64_t id_;
+    std::mutex mtx_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+  };
+
+  /////////////////////////////////////////////////////////
+  // WriterCounters - written only by the write thread
+
+  struct WriterCounters {
+    std::atomic<uint64_t> batches{ 0 };
+    std::atomic<uint64_t> messages{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<uint64_t> busyNs{ 0 };
+    std::atomic<uint64_t> idleNs{ 0 };
+    std::atomic<uint64_t> highWater{ 0 };
+    std::atomic<uint64_t> coalesced{ 0 };
+    std::atomic<uint64_t> commits{ 0 };
+    LatencyHistogram latency;
+  };
+
+  /////////////////////////////////////////////////////////
+  // SinkStats - one stream's progress
+
+  struct SinkStats {
+    ISink* pSink = nullptr;
+    std::ostream* pStrm = nullptr;
+    size_t writtenMessages = 0;
+    size_t writtenBytes = 0;
+    size_t lagMessages = 0;
+    size_t lagBytes = 0;
+    bool detached = false;
+  };
+
+  /////////////////////////////////////////////////////////
+  // LoggerStats - snapshot returned by QTestLogger::stats()
+
+  struct LoggerStats {
+    size_t queueDepth = 0;
+    size_t highWaterDepth = 0;
+    uint64_t posted = 0;
+    uint64_t postedBytes = 0;
+    uint64_t batches = 0;
+    uint64_t writtenMessages = 0;
+    uint64_t writtenBytes = 0;
+    uint64_t coalesced = 0;
+    uint64_t commits = 0;
+    uint64_t synced = 0;
+    double busyMicrosecs = 0.0;
+    double idleMicrosecs = 0.0;
+    LatencyHistogram latency;
+    std::vector<SinkStats> sinks;
+
+    double busyFraction() const {
+      double total = busyMicrosecs + idleMicrosecs;
+      return total > 0.0 ? busyMicrosecs / total : 0.0;
+    }
+  };
+}
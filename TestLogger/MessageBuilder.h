@@ -0,0 +1,186 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// MessageBuilder.h - Allocation-free log message builder              //
+// ver 1.0                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   MessageBuilder assembles a log message from values of many types:
+     MessageBuilder mb;
+     mb << "count = " << 42 << ", ratio = " << 0.25 << ", ids = " << ids;
+     logger.post(mb);
+   - text is stored in a LogRecord, so messages under 240 chars stay
+     in the builder, on the stack, and longer ones spill to pooled
+     buffers
+   - add(value) and operator<< accept:
+     - std::string, std::string_view, C strings, and char
+     - bool, as true or false
+     - integers and enums, formatted with std::to_chars
+     - floating point, shortest round-trip form with std::to_chars,
+       or addFixed(value, precision)
+     - pointers, in hex
+     - std::pair, as (first, second)
+     - sequence and set containers, as [e1, e2, ...], and maps, as
+       {key: value, ...}, with elements formatted by these rules
+   - loggers' post(const MessageBuilder&) reads the builder's text in
+     place, with no intermediate std::string
+   - clear() empties the builder for reuse, keeping any spill buffer
+
+   Dependencies:
+  ---------------
+   MessageBuilder.h
+   LogRecord.h
+   TypeTraits.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include "LogRecord.h"
+#include "../type_traits/TypeTraits.h"
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cstdint>
+#include <type_traits>
+
+namespace Test {
+
+  template<typename T>
+  struct builder_dependent_false : std::false_type {};
+
+  /////////////////////////////////////////////////////////
+  // MessageBuilder class
+
+  class MessageBuilder {
+  public:
+    MessageBuilder() {}
+    explicit MessageBuilder(std::string_view text) {
+      text_.append(text);
+    }
+    template<typename T>
+    MessageBuilder& add(const T& value);
+    MessageBuilder& add(const char* pText) {
+      text_.append(pText);
+      return *this;
+    }
+    MessageBuilder& addFixed(double value, int precision);
+    template<typename T>
+    MessageBuilder& operator<<(const T& value) {
+      return add(value);
+    }
+    MessageBuilder& operator<<(const char* pText) {
+      return add(pText);
+    }
+    std::string_view view() const { return text_.view(); }
+    const char* data() const { return text_.data(); }
+    size_t size() const { return text_.size(); }
+    bool empty() const { return text_.empty(); }
+    void clear() { text_.clear(); }
+    std::string toString() const { return text_.toString(); }
+  protected:
+    template<typename T>
+    void appendChars(T value);
+    template<typename C>
+    void appendRange(const C& container, char open, char close);
+    LogRecord text_;
+  };
+
+  /*-- format value with std::to_chars, then append it --*/
+  template<typename T>
+  inline void MessageBuilder::appendChars(T value) {
+    char buf[32];
+    auto res = std::to_chars(buf, buf + sizeof(buf), value);
+    text_.append(buf, static_cast<size_t>(res.ptr - buf));
+  }
+  /*-- append container elements between open and close --*/
+  template<typename C>
+  inline void MessageBuilder::appendRange(const C& container, char open, char close) {
+    text_.append(&open, 1);
+    bool first = true;
+    for (const auto& elem : container) {
+      if (!first)
+        text_.append(", ", 2);
+      first = false;
+      if constexpr (is_map<C>::value || is_multimap<C>::value ||
+        is_unordered_map<C>::value || is_unordered_multimap<C>::value) {
+        add(elem.first);
+        text_.append(": ", 2);
+        add(elem.second);
+      }
+      else {
+        add(elem);
+      }
+    }
+    text_.append(&close, 1);
+  }
+  /*-----------------------------------------------------
+    append one value, see package responsibilities for
+    supported types
+  */
+  template<typename T>
+  inline MessageBuilder& MessageBuilder::add(const T& value) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+      text_.append(std::string_view(value));
+    }
+    else if constexpr (std::is_base_of_v<MessageBuilder, U>) {
+      text_.append(value.view());
+    }
+    else if constexpr (std::is_same_v<U, bool>) {
+      text_.append(value ? "true" : "false");
+    }
+    else if constexpr (std::is_same_v<U, char>) {
+      text_.append(&value, 1);
+    }
+    else if constexpr (std::is_integral_v<U> || std::is_floating_point_v<U>) {
+      appendChars(value);
+    }
+    else if constexpr (std::is_enum_v<U>) {
+      appendChars(static_cast<std::underlying_type_t<U>>(value));
+    }
+    else if constexpr (std::is_pointer_v<U>) {
+      text_.append("0x", 2);
+      char buf[32];
+      auto res = std::to_chars(buf, buf + sizeof(buf), reinterpret_cast<uintptr_t>(value), 16);
+      text_.append(buf, static_cast<size_t>(res.ptr - buf));
+    }
+    else if constexpr (is_pair<U>::value) {
+      text_.append("(", 1);
+      add(value.first);
+      text_.append(", ", 2);
+      add(value.second);
+      text_.append(")", 1);
+    }
+    else if constexpr (is_map<U>::value || is_multimap<U>::value ||
+      is_unordered_map<U>::value || is_unordered_multimap<U>::value) {
+      appendRange(value, '{', '}');
+    }
+    else if constexpr (is_seqcont<U>::value || is_assoccont<U>::value) {
+      appendRange(value, '[', ']');
+    }
+    else {
+      static_assert(builder_dependent_false<U>::value, "unsupported MessageBuilder argument type");
+    }
+    return *this;
+  }
+  /*-- append value with precision digits after the decimal point --*/
+  inline MessageBuilder& MessageBuilder::addFixed(double value, int precision) {
+    char buf[64];
+    auto res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, precision);
+    if (res.ec == std::errc())
+      text_.append(buf, static_cast<size_t>(res.ptr - buf));
+    else
+      appendChars(value);
+    return *this;
+  }
+
+  inline std::ostream& operator<<(std::ostream& out, const MessageBuilder& mb) {
+    return out.write(mb.data(), static_cast<std::streamsize>(mb.size()));
+  }
+}
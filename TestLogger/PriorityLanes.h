@@ -0,0 +1,145 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// PriorityLanes.h - Per-level lanes drained by priority               //
+// ver 1.1                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Lets a write thread write important records ahead of a backlog of
+   less important ones:
+   - add(rec, lane) appends a record, taken from the write queue, to
+     one of N lanes, lane 0 most important.  Each lane is FIFO, so
+     records from one producer keep their order within a lane.
+   - take(batch, maxCount, drain, weight) moves up to maxCount records
+     to batch:
+     - Drain::strict:   lane 0 until empty, then lane 1, and so on
+     - Drain::weighted: in rounds, lane i giving up to weight times
+                        as many records as lane i + 1, so no lane
+                        starves
+     - Drain::fifo:     lanes are not used, see QTestLogger
+   - done() is the number of records added before the oldest one
+     still held, so every record counted has been taken.  A write
+     thread publishes that as written, which keeps waits on tickets,
+     numbered in queue order, correct when lanes reorder writes.
+   - weighted rounds carry over from one take to the next, so a
+     maxCount smaller than a round still reaches every lane.
+   - skip(count) counts records that finished without entering the
+     lanes, e.g., evicted from the write queue, as added before the
+     next record, so done() includes them only once every record
+     added earlier has been taken.
+
+   QTestLogger::setLanes(drain, syncDepth, weight) owns one
+   PriorityLanes, used only by its write thread.
+
+   Dependencies:
+  ---------------
+   PriorityLanes.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.1 : 16 Oct 2026
+   - added skip
+   - weighted rounds continue across takes
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <vector>
+#include <deque>
+#include <array>
+#include <algorithm>
+#include <cstddef>
+
+namespace Test {
+
+  enum class Drain {
+    fifo, strict, weighted
+  };
+
+  /////////////////////////////////////////////////////////
+  // PriorityLanes - write thread state of one logger
+
+  template<typename T, size_t N>
+  class PriorityLanes {
+  public:
+    void add(T&& rec, size_t lane);
+    bool empty() const { return held_ == 0; }
+    size_t size() const { return held_; }
+    size_t take(std::vector<T>& batch, size_t maxCount, Drain drain, size_t weight);
+    size_t done() const;
+    void skip(size_t count) { nextSeq_ += count; }
+  private:
+    struct Entry {
+      size_t seq;
+      T rec;
+    };
+    size_t takeFrom(size_t lane, std::vector<T>& batch, size_t count);
+
+    std::array<std::deque<Entry>, N> lanes_;
+    std::array<size_t, N> credit_{};
+    size_t nextSeq_ = 0;
+    size_t held_ = 0;
+  };
+
+  /*-- append rec to lane, clamped to the last lane --*/
+  template<typename T, size_t N>
+  void PriorityLanes<T, N>::add(T&& rec, size_t lane) {
+    lanes_[(std::min)(lane, N - 1)].push_back(Entry{ nextSeq_++, std::move(rec) });
+    ++held_;
+  }
+  /*-- move up to count records from front of lane to batch --*/
+  template<typename T, size_t N>
+  size_t PriorityLanes<T, N>::takeFrom(size_t lane, std::vector<T>& batch, size_t count) {
+    auto& q = lanes_[lane];
+    count = (std::min)(count, q.size());
+    for (size_t i = 0; i < count; ++i) {
+      batch.push_back(std::move(q.front().rec));
+      q.pop_front();
+    }
+    held_ -= count;
+    return count;
+  }
+  /*-----------------------------------------------------
+    move up to maxCount records to batch, in drain order
+    - weighted rounds give lane N - 1 one record, and
+      each lane above it weight times the one below
+    - credit_ holds what each lane may still give in
+      the current round, and an empty lane gives up
+      the rest of its share
+  */
+  template<typename T, size_t N>
+  size_t PriorityLanes<T, N>::take(std::vector<T>& batch, size_t maxCount, Drain drain, size_t weight) {
+    size_t taken = 0;
+    if (drain != Drain::weighted) {
+      for (size_t lane = 0; lane < N && taken < maxCount; ++lane)
+        taken += takeFrom(lane, batch, maxCount - taken);
+      return taken;
+    }
+    std::array<size_t, N> quota;
+    size_t share = 1;
+    for (size_t lane = N; lane-- > 0; share *= (std::max)(weight, size_t(1)))
+      quota[lane] = share;
+    while (taken < maxCount && held_ > 0) {
+      if (std::all_of(credit_.begin(), credit_.end(), [](size_t c) { return c == 0; }))
+        credit_ = quota;
+      for (size_t lane = 0; lane < N && taken < maxCount; ++lane) {
+        size_t count = takeFrom(lane, batch, (std::min)(credit_[lane], maxCount - taken));
+        credit_[lane] = lanes_[lane].empty() ? 0 : credit_[lane] - count;
+        taken += count;
+      }
+    }
+    return taken;
+  }
+  /*-- count of records added before the oldest one held --*/
+  template<typename T, size_t N>
+  size_t PriorityLanes<T, N>::done() const {
+    size_t oldest = nextSeq_;
+    for (auto& q : lanes_) {
+      if (!q.empty())
+        oldest = (std::min)(oldest, q.front().seq);
+    }
+    return oldest;
+  }
+}
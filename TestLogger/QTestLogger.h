@@ -1,7 +1,7 @@
 #pragma once
 /////////////////////////////////////////////////////////////////////////
 // QTestLogger.h - Logs to multiple streams using post queue           //
-// ver 1.1                                                             //
+// ver 1.8                                                             //
 // Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
 /////////////////////////////////////////////////////////////////////////
 /*
@@ -9,21 +9,41 @@
   ---------------------------
    Package provides IQTestLogger interface, QTestLogger class, and two factories:
    - Write log messages to multiple streams
-   - Accept strings or messages convertible to string
+   - Accept strings, MessageBuilders, or messages convertible to string
    QTestLogger<N> posts to write queue.  Child thread deQs and writes to streams.
+   - QTestLogger<L, Q> takes a queue policy Q, defaulting to BlockingQueue.
+     RingQTestLogger<L> selects the lock-free MpscRingBuffer.
+   - Steady state posts take no lock and make no heap allocations, see
+     LogRecord.h, and prefix and suffix are read from a snapshot.
    - QTestLogger<N> provides:
-     - post(msg) and postDated(msg)
-     - addStream(pStrm), removeStream(pStrm), streamCount()
+     - post(msg) and postDated(msg), msg a std::string, MessageBuilder,
+       or FieldRecord, see StructuredLog.h
+     - postAt(level, msg), posting at one of the levels in L
+     - addStream(pStrm, format), removeStream(pStrm), streamCount()
+     - addSink(pSink, format), removeSink(pSink), see LogSinks.h
      - clear()
      - start(), stop(), and elapsedMicroseconds()
-     - wait()
+     - wait(), ticket(), and waitFor(ticket, timeoutMillisecs)
+     - postTicket(msg, durability) and whenWritten(pCompletion), see AsyncPost.h
+     - setDurability(durability, commitMicrosecs), group commit
      - setPrefix(prfx) and setSuffix(suffx)
+     - setBatching(maxBatch, lingerMicrosecs), many posts per stream write
+     - setCoalescing(on, flushMillisecs), see RepeatCoalescer.h
+     - setLanes(drain, syncDepth, weight), see PriorityLanes.h
+     - postDeferred(formatId, args...) and setDeferredSink(pBinaryStrm),
+       see DeferredLog.h
+     - setCapacity(maxMessages, maxBytes, policy, keepLevel), dropped(level)
+     - setFanOut(on, maxLagBytes) and sinkStats(), see SinkFanOut.h
+     - stats(), see LoggerStats.h
+     - enableCrashFlush(fds) and disableCrashFlush(), see CrashFlush.h
 
    Requires:
   -----------
    - C++17 option:
      Properties > C/C++ > Language > C++ Language Standard 
                 > ISO C++17 standard (/std:c++17)
+     postAsync, see AsyncPost.h, needs ISO C++20 standard (/std:c++20),
+     which TestLogger.vcxproj selects
    - Catch C Exception:
      Properties > C/C++ > Code Generation > Enable C++ Exceptions 
                 > Yes with SEH Exceptions (/EHa)
@@ -35,10 +55,74 @@
    ITestLogger.h
    TestLogger.h, TestLogger.cpp (only for demonstration)
    DateTime.h, DateTime.cpp
+   Cpp11-BlockingQueue.h
+   MpscRingBuffer.h
+   DeferredLog.h
+   StructuredLog.h
+   LogRecord.h
+   LoggerStats.h
+   CrashFlush.h
+   RepeatCoalescer.h
+   AsyncPost.h
+   PriorityLanes.h
+   SinkFanOut.h
    TypeTraits.h
 
    Maintenance History:
   ----------------------
+   ver 1.8 : 16 Oct 2026
+   - evictions never take the stop record, and don't allocate
+   - posts read prefix and suffix from a published snapshot instead
+     of taking streamsMtx_
+   - posts default to Durability::none at every level, and the group
+     commit window waits on the queue, only when a sink can sync
+   - fan-out batches are published, and fan-out closed, without
+     holding streamsMtx_
+   - with lanes, evictions are published only once every older
+     record held in the lanes is written
+   - posts made by completions are queued past capacity rather than
+     block, dropped only when a RingQTestLogger ring is full
+   - the write thread shrinks batches left far larger than their last
+     use, as BlockingQueue does its storage
+   - package comment cut to a feature list, details are in function
+     comments and each feature's header
+   ver 1.7 : 16 Oct 2026
+   - added postAt, setLanes, priority lanes, and synchronous results
+     writes past a queue depth
+   ver 1.6 : 16 Oct 2026
+   - added Durability, setDurability, and group commit of durable posts
+   ver 1.5 : 16 Oct 2026
+   - added postTicket and whenWritten, write completions for postAsync
+   ver 1.4 : 16 Oct 2026
+   - added setCoalescing, collapsing runs of repeated messages
+   ver 1.3 : 16 Oct 2026
+   - added enableCrashFlush and disableCrashFlush
+   ver 1.2 : 16 Oct 2026
+   - added queue policy template parameter and RingQTestLogger
+   - corePost builds message in a local string and moves it into the
+     queue, so concurrent posts no longer share composite_
+   - write thread drains messages in batches, one write per stream
+     per batch, see setBatching(...)
+   - wait() blocks on a flush barrier instead of polling queue size,
+     added ticket() and waitFor(ticket, timeout)
+   - post and postDated now honor logLevel, like TestLogger
+   - write thread and posts use TestLogger's stream locks, so streams
+     may be added and removed while messages are being written
+   - queue carries QRecord, holding text or a deferred record, and a
+     stop record replaces the "stop" string sentinel
+   - added postDeferred, setDeferredSink, and TEST_POST_DEFERRED
+   - postDated uses TestLogger's TimestampFormatter timestamps
+   - added setCapacity, Overflow policies, and dropped message counts
+   - added fan-out mode, setFanOut and sinkStats
+   - added addSink and removeSink overrides for native sinks
+   - QRecord text is a LogRecord, assembled in place by corePost, so
+     posts no longer allocate a message string
+   - added post and postDated overloads for MessageBuilder
+   - added stats(): queue depth and high-water mark, latency histogram,
+     per-thread post counts, per-stream totals, and write thread busy
+     and idle time
+   - added post and postDated overloads for FieldRecord, batches are
+     rendered for each stream's SinkFormat
    ver 1.1 : 30 Jan 2020
    - removed template argument size_t N on loggers
      That argument remains for factories so we can more than one "singleTon" logger
@@ -49,8 +133,17 @@
 
 #include "IQTestLogger.h"
 #include "TestLogger.h"
+#include "DeferredLog.h"
+#include "StructuredLog.h"
+#include "LogRecord.h"
+#include "SinkFanOut.h"
+#include "CrashFlush.h"
+#include "RepeatCoalescer.h"
+#include "AsyncPost.h"
+#include "PriorityLanes.h"
 #include "../DateTime/DateTime.h"
 #include "../Cpp11-BlockingQueue/Cpp11-BlockingQueue.h"
+#include "../MpscRingBuffer/MpscRingBuffer.h"
 #include "../type_traits/TypeTraits.h"
 #include <iostream>
 #include <string>
@@ -58,7 +151,15 @@
 #include <vector>
 #include <algorithm>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <array>
+#include <type_traits>
+#include <cstddef>
 
 namespace Test {
 
@@ -83,104 +184,1321 @@ namespace Test {
   */
 #pragma warning(disable : 4250)
 
+  /////////////////////////////////////////////////////////
+  // QRecord - element of QTestLogger's write queue
+
+  struct QRecord {
+    enum class Kind : uint8_t { text, deferred, fields, stop };
+    Kind kind = Kind::text;
+    Level level = Level::all;
+    Durability durability = Durability::none;
+    size_t charge = 0;
+    uint64_t enqueuedNs = 0;
+    LogRecord text;
+    DeferredRecord deferred;
+  };
+
+  /*-- index of level in per-level counters --*/
+  inline size_t levelIndex(Level l) {
+    switch (l) {
+    case Level::results: return 0;
+    case Level::demo:    return 1;
+    case Level::debug:   return 2;
+    default:             return 3;
+    }
+  }
+
+  /*-----------------------------------------------------
+    can threads other than the write thread dequeue from
+    queue policy Q, needed for Overflow::overwriteOldest
+  */
+  template<typename Q>
+  struct allowsConcurrentDeQ : std::true_type {};
+
+  template<typename T>
+  struct allowsConcurrentDeQ<MpscRingBuffer<T>> : std::false_type {};
+
   /////////////////////////////////////////////////////////
   // QTestLogger class
+  // - Q is the write queue policy.  It must provide enQ(T&&) returning
+  //   a ticket, enqueued(), blocking deQAll(batch, max), timed
+  //   deQAllFor(batch, max, timeout), non-blocking tryDeQAll(batch, max),
+  //   size(), and peekUnsafe(f) for T = QRecord, as do BlockingQueue<T>
+  //   and MpscRingBuffer<T>.  Queues allowing concurrent dequeues also
+  //   provide tryDeQIf(t, pred), see evictOldest.
+  // - privately an ICrashFlush, see enableCrashFlush
 
-  template<Level L = Level::all>
-  class QTestLogger : public IQTestLogger<L>, public TestLogger<L> {
+  template<Level L = Level::all, typename Q = BlockingQueue<QRecord>>
+  class QTestLogger : public IQTestLogger<L>, public TestLogger<L>, private ICrashFlush {
   public:
+    using Queue = Q;
 
     QTestLogger() {
-      wthread = std::move(std::thread(&QTestLogger<L>::writeThreadProc, this));
+      publishAffixes();
+      wthread = std::move(std::thread(&QTestLogger<L, Q>::writeThreadProc, this));
     }
-    QTestLogger(std::ostream& pStrm) {
-      wthread = std::move(std::thread(&QTestLogger<L>::writeThreadProc, this));
+    QTestLogger(std::ostream* pStrm) {
+      publishAffixes();
+      wthread = std::move(std::thread(&QTestLogger<L, Q>::writeThreadProc, this));
       this->addStream(pStrm);
     }
     virtual ~QTestLogger();
     virtual void wait();
+    virtual size_t ticket();
+    virtual bool waitFor(size_t ticket, size_t timeoutMillisecs = SIZE_MAX);
+    template<typename Msg>
+    size_t postTicket(const Msg& msg) { return postTicket(msg, durability()); }
+    template<typename Msg>
+    size_t postTicket(const Msg& msg, Durability durability);
+    bool whenWritten(WriteCompletion* pDone);
     virtual void start();
     virtual void stop();
     virtual double elapsedMicroseconds();
+    virtual void setBatching(size_t maxBatch, size_t lingerMicrosecs = 0);
+    virtual void setCoalescing(bool on, size_t flushMillisecs = 1000);
+    virtual void setDurability(Durability durability, size_t commitMicrosecs = 500) override;
+    virtual Durability durability() override { return durability_.load(std::memory_order_relaxed); }
+    virtual void setLanes(Drain drain, size_t syncDepth = 0, size_t weight = 4) override;
+    virtual void setCapacity(
+      size_t maxMessages, size_t maxBytes = 0,
+      Overflow policy = Overflow::block, Level keepLevel = Level::results
+    );
+    virtual size_t dropped(Level l);
+    virtual size_t dropped();
+    virtual void setFanOut(bool on, size_t maxLagBytes = 0);
+    std::vector<SinkStats> sinkStats();
+    virtual LoggerStats stats() override;
+    virtual void enableCrashFlush(const std::vector<int>& fds = { 2 }) override;
+    virtual void disableCrashFlush() override;
+    virtual void addStream(std::ostream* pStrm, SinkFormat format = SinkFormat::text) override;
+    virtual bool removeStream(std::ostream* pStrm) override;
+    virtual void addSink(ISink* pSink, SinkFormat format = SinkFormat::text) override;
+    virtual bool removeSink(ISink* pSink) override;
     virtual void clear() override;
+    virtual ITestLogger<L>& setPrefix(const std::string& prefix) override;
+    virtual ITestLogger<L>& setSuffix(const std::string& suffix) override;
     virtual ITestLogger<L>& post(const std::string& msg) override;
     virtual ITestLogger<L>& postDated(const std::string& msg) override;
+    virtual ITestLogger<L>& post(const MessageBuilder& msg) override;
+    virtual ITestLogger<L>& postDated(const MessageBuilder& msg) override;
+    virtual ITestLogger<L>& post(const FieldRecord& rec) override;
+    virtual ITestLogger<L>& postDated(const FieldRecord& rec) override;
+    template<typename Msg>
+    ITestLogger<L>& postAt(Level level, const Msg& msg);
+    template<typename... Args>
+    ITestLogger<L>& postDeferred(FormatId id, const Args&... args);
+    void setDeferredSink(std::ostream* pBinaryStrm);
   protected:
-    void corePost(const std::string& msg);
+    using Rendered = typename TestLogger<L>::Rendered;
+    struct Affixes {
+      std::string prefix;
+      std::string suffix;
+    };
+    void publishAffixes();
+    size_t corePost(std::string_view msg, std::string_view stamp, Durability durability, Level level = L);
+    void coreDated(std::string_view msg);
+    size_t coreFields(const FieldRecord& rec, Durability durability, Level level = L);
+    void renderDeferred(Rendered& out, const DeferredRecord& r, std::string& scratch);
+    size_t enQRecord(QRecord&& rec, Level level = L);
+    bool writeNow(const QRecord& rec);
+    Overflow policyFor(Level level);
+    bool admit(size_t charge, Level level);
+    bool hasRoom(size_t charge);
+    bool evictOldest();
+    void release(size_t count, size_t bytes);
+    void appendDropNotice(std::string& buffer, std::array<size_t, 4>& reported);
+    bool coalesce(RepeatCoalescer& c, const QRecord& rec, Rendered& out, std::string& scratch, uint64_t now);
+    void renderRepeats(RepeatCoalescer& c, Rendered& out, std::string& scratch);
+    virtual void crashFlush(int signal) noexcept override;
+    void crashWrite(CrashOutput& out, const QRecord& rec) noexcept;
+    std::ostream* pDeferredSink_ = nullptr;
+    std::atomic<const Affixes*> pAffixes_{ nullptr };
+    std::vector<std::unique_ptr<const Affixes>> affixes_;  // guarded by affixMtx_
+    std::mutex affixMtx_;
+    std::shared_ptr<SinkFanOut> pFanOut_;
+    std::mutex fanOutMtx_;
+    std::unique_ptr<CrashOutput> pCrashOut_;
+    std::atomic<const QRecord*> crashBatch_{ nullptr };
+    std::atomic<size_t> crashBatchSize_{ 0 };
     std::thread wthread;
-    BlockingQueue<std::string> writeQ_;
+    Q writeQ_;
+    std::atomic<size_t> maxBatch_{ 256 };
+    std::atomic<size_t> lingerMicrosecs_{ 0 };
+    std::atomic<bool> coalescing_{ false };
+    std::atomic<size_t> coalesceMillisecs_{ 1000 };
+    std::atomic<Durability> durability_{ Durability::none };
+    std::atomic<size_t> commitMicrosecs_{ 500 };
+    std::atomic<Drain> drain_{ Drain::fifo };
+    std::atomic<size_t> syncDepth_{ 0 };
+    std::atomic<size_t> laneWeight_{ 4 };
+    std::atomic<size_t> synced_{ 0 };
+    std::atomic<size_t> queuedResults_{ 0 };
+    std::atomic<size_t> written_{ 0 };
+    std::atomic<size_t> waiters_{ 0 };
+    std::mutex writtenMtx_;
+    std::condition_variable writtenCv_;
+    CompletionHeap completions_;
+    std::atomic<size_t> maxMessages_{ 0 };
+    std::atomic<size_t> maxBytes_{ 0 };
+    std::atomic<Overflow> overflow_{ Overflow::block };
+    std::atomic<Level> keepLevel_{ Level::results };
+    std::atomic<size_t> queuedCount_{ 0 };
+    std::atomic<size_t> queuedBytes_{ 0 };
+    std::atomic<size_t> evicted_{ 0 };
+    std::array<std::atomic<size_t>, 4> dropped_{};
+    std::atomic<size_t> spaceWaiters_{ 0 };
+    std::mutex spaceMtx_;
+    std::condition_variable spaceCv_;
+    ThreadCounters postCounters_;
+    WriterCounters writerCounters_;
+    void publishWritten(size_t count);
+    void commitSinks(Durability durability);
+    bool canSync();
+    void recordDepth();
+    void recordBatch(const std::vector<QRecord>& batch, size_t messages, size_t bytes);
+    static void trimBatch(std::vector<QRecord>& batch, size_t used);
     void writeThreadProc();
   };
 
   /*-- remove all streams, closing file streams --*/
-  template<Level L>
-  QTestLogger<L>::~QTestLogger() {
-    writeQ_.enQ("stop");
+  template<Level L, typename Q>
+  QTestLogger<L, Q>::~QTestLogger() {
+    postPendingSummaries<L>(*this);
+    disableCrashFlush();
+    QRecord stopRec;
+    stopRec.kind = QRecord::Kind::stop;
+    writeQ_.enQ(std::move(stopRec));
     if (wthread.joinable())
       wthread.join();
+    setFanOut(false);
     clear();
   }
-  /*-- wait for writeQ to empty --*/
-  template<Level L>
-  void QTestLogger<L>::wait() {
-    while (writeQ_.size() > 0)
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  /*-- report suppressed occurrences, then wait until every message queued so far has been written --*/
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::wait() {
+    postPendingSummaries<L>(*this);
+    waitFor(ticket());
+  }
+  /*-- ticket of latest queued message, from any thread --*/
+  template<Level L, typename Q>
+  size_t QTestLogger<L, Q>::ticket() {
+    return writeQ_.enqueued();
+  }
+  /*-----------------------------------------------------
+    wait until message with ticket t has been written
+    - returns false if timeoutMillisecs elapses first
+    - write thread only takes writtenMtx_ when there
+      are waiters, so posts don't pay for this
+  */
+  template<Level L, typename Q>
+  bool QTestLogger<L, Q>::waitFor(size_t t, size_t timeoutMillisecs) {
+    if (written_.load() >= t)
+      return true;
+    std::unique_lock<std::mutex> l(writtenMtx_);
+    ++waiters_;
+    auto done = [this, t]() { return written_.load() >= t; };
+    bool result = true;
+    if (timeoutMillisecs == SIZE_MAX)
+      writtenCv_.wait(l, done);
+    else
+      result = writtenCv_.wait_for(l, std::chrono::milliseconds(timeoutMillisecs), done);
+    --waiters_;
+    return result;
+  }
+  /*-----------------------------------------------------
+    write thread announces count more messages fully
+    written, then completes every ready WriteCompletion
+    - stream threads announce in fan-out mode
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::publishWritten(size_t count) {
+    size_t written = written_.fetch_add(count) + count;
+    if (waiters_.load() > 0) {
+      { std::lock_guard<std::mutex> l(writtenMtx_); }
+      writtenCv_.notify_all();
+    }
+    if (completions_.empty())
+      return;
+    thread_local std::vector<WriteCompletion*> ready;
+    ready.clear();
+    completions_.takeReady(written, ready);
+    bool& completing = inCompletion();
+    bool wasCompleting = completing;
+    completing = true;
+    for (auto pDone : ready)
+      pDone->complete(pDone);
+    completing = wasCompleting;
+  }
+  /*-----------------------------------------------------
+    flush or sync every sink once, and the deferred sink,
+    caller holds streamsMtx_ shared
+    - stream threads commit their own streams in fan-out
+      mode, see SinkFanOut
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::commitSinks(Durability durability) {
+    for (auto& sink : this->streams_) {
+      if (pFanOut_ != nullptr)
+        break;
+      std::lock_guard<std::mutex> g(*sink.pLock);
+      applyDurability(*sink.writer(), durability);
+    }
+    if (pDeferredSink_ != nullptr)
+      pDeferredSink_->flush();
+    bump(writerCounters_.commits);
+  }
+  /*-- can a commit reach stable storage on any sink --*/
+  template<Level L, typename Q>
+  bool QTestLogger<L, Q>::canSync() {
+    std::shared_lock<std::shared_mutex> l(this->streamsMtx_);
+    for (auto& sink : this->streams_) {
+      if (sink.writer()->canSync())
+        return true;
+    }
+    return false;
+  }
+  /*-----------------------------------------------------
+    call pDone->complete(pDone) once pDone->ticket is
+    written, from the thread publishing it
+    - returns false, without registering, if it is
+      already written
+  */
+  template<Level L, typename Q>
+  bool QTestLogger<L, Q>::whenWritten(WriteCompletion* pDone) {
+    return completions_.add(pDone, written_);
   }
   /*-- start timer --*/
-  template<Level L>
-  void QTestLogger<L>::start() {
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::start() {
     this->dt.start();
   }
   /*-- stop timer --*/
-  template<Level L>
-  void QTestLogger<L>::stop() {
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::stop() {
     this->dt.stop();
   }
   /*-- timer elapsed microseconds --*/
-  template<Level L>
-  double QTestLogger<L>::elapsedMicroseconds() {
+  template<Level L, typename Q>
+  double QTestLogger<L, Q>::elapsedMicroseconds() {
     return this->dt.elapsedMicroseconds();
   }
+  /*-----------------------------------------------------
+    set write thread batching
+    - maxBatch is largest number of messages written per
+      stream write, 1 writes each message separately
+    - lingerMicrosecs is time to wait for a partial batch
+      to fill, 0 writes whatever is queued immediately
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::setBatching(size_t maxBatch, size_t lingerMicrosecs) {
+    maxBatch_.store(maxBatch > 0 ? maxBatch : 1);
+    lingerMicrosecs_.store(lingerMicrosecs);
+  }
+  /*-----------------------------------------------------
+    turn coalescing of repeated messages on or off
+    - a run's repeat count is written at most
+      flushMillisecs after its first repeat
+    - turning it off writes any pending count
+    - dated posts, and deferred records sent to a
+      deferred sink, are never repeats
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::setCoalescing(bool on, size_t flushMillisecs) {
+    coalesceMillisecs_.store(flushMillisecs);
+    coalescing_.store(on);
+  }
+  /*-----------------------------------------------------
+    set durability of later posts, and group commit time
+    - the write thread flushes or syncs each sink once
+      per batch, for its most durable post, before the
+      batch counts as written, in fan-out mode each
+      stream thread commits its own stream
+    - commitMicrosecs is the longest the write thread
+      waits for more posts to share an fsynced batch's
+      commit, 0 commits at once.  It stops waiting when
+      the batch fills or no post arrives in time, and
+      doesn't wait at all unless a sink can sync, see
+      ISink::canSync
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::setDurability(Durability durability, size_t commitMicrosecs) {
+    durability_.store(durability);
+    commitMicrosecs_.store(commitMicrosecs);
+  }
+  /*-----------------------------------------------------
+    order writes by level, see Drain
+    - weight is how many times more posts each level
+      gets in a weighted batch than the next one down
+    - syncDepth > 0 writes results posts from the posting
+      thread while more than syncDepth posts are unwritten,
+      none of them results, so results keep their order.
+      Those posts return ticket 0, count in stats().synced,
+      and aren't made in fan-out mode
+    - tickets stay in queue order, a ticket counts as
+      written once every earlier post is
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::setLanes(Drain drain, size_t syncDepth, size_t weight) {
+    drain_.store(drain);
+    syncDepth_.store(syncDepth);
+    laneWeight_.store(weight);
+  }
+  /*-----------------------------------------------------
+    bound write queue, 0 turns a limit off
+    - maxMessages and maxBytes limit queued posts and the
+      bytes they hold, a post bigger than maxBytes is
+      still accepted by an empty queue
+    - policy and keepLevel choose what happens to posts
+      that don't fit, see Overflow.  A RingQTestLogger's
+      ring, 8192 records, applies the policy when full
+      even with no limits set
+    - discards are reported in a "N messages dropped"
+      line after the next batch written
+    - posts from completions never block, see admit
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::setCapacity(
+    size_t maxMessages, size_t maxBytes, Overflow policy, Level keepLevel
+  ) {
+    maxMessages_.store(maxMessages);
+    maxBytes_.store(maxBytes);
+    overflow_.store(policy);
+    keepLevel_.store(keepLevel);
+    { std::lock_guard<std::mutex> l(spaceMtx_); }
+    spaceCv_.notify_all();
+  }
+  /*-- number of posts at level l discarded by overflow policy --*/
+  template<Level L, typename Q>
+  size_t QTestLogger<L, Q>::dropped(Level l) {
+    return dropped_[levelIndex(l)].load();
+  }
+  /*-- number of posts discarded by overflow policy --*/
+  template<Level L, typename Q>
+  size_t QTestLogger<L, Q>::dropped() {
+    size_t total = 0;
+    for (auto& count : dropped_)
+      total += count.load();
+    return total;
+  }
+  /*-- is there space for a post holding charge bytes --*/
+  template<Level L, typename Q>
+  bool QTestLogger<L, Q>::hasRoom(size_t charge) {
+    size_t maxMessages = maxMessages_.load();
+    size_t maxBytes = maxBytes_.load();
+    size_t count = queuedCount_.load();
+    if (count == 0)
+      return true;
+    return (maxMessages == 0 || count < maxMessages) &&
+      (maxBytes == 0 || queuedBytes_.load() + charge <= maxBytes);
+  }
+  /*-- policy for a post at level that doesn't fit, dropBelowLevel resolved --*/
+  template<Level L, typename Q>
+  Overflow QTestLogger<L, Q>::policyFor(Level level) {
+    Overflow policy = overflow_.load();
+    if (policy == Overflow::dropBelowLevel) {
+      bool keep = levelValue(level) <= levelValue(keepLevel_.load());
+      policy = keep ? Overflow::block : Overflow::dropNewest;
+    }
+    return policy;
+  }
+  /*-----------------------------------------------------
+    reserve queue space for a post, applying overflow
+    policy when there is none
+    - returns false if the post is to be discarded
+    - posts from completions never wait, they are admitted
+      past capacity, see inCompletion() in AsyncPost.h
+  */
+  template<Level L, typename Q>
+  bool QTestLogger<L, Q>::admit(size_t charge, Level level) {
+    while (true) {
+      size_t maxMessages = maxMessages_.load();
+      size_t maxBytes = maxBytes_.load();
+      size_t count = queuedCount_.fetch_add(1) + 1;
+      size_t bytes = queuedBytes_.fetch_add(charge) + charge;
+      if (count == 1 ||
+        ((maxMessages == 0 || count <= maxMessages) && (maxBytes == 0 || bytes <= maxBytes)))
+        return true;
+      release(1, charge);
+
+      Overflow policy = policyFor(level);
+      if (policy == Overflow::overwriteOldest) {
+        if constexpr (allowsConcurrentDeQ<Q>::value) {
+          if (evictOldest())
+            continue;
+          policy = Overflow::block;
+        }
+        else {
+          policy = Overflow::dropNewest;
+        }
+      }
+      if (policy == Overflow::dropNewest) {
+        dropped_[levelIndex(level)].fetch_add(1);
+        return false;
+      }
+      if (inCompletion()) {
+        queuedCount_.fetch_add(1);
+        queuedBytes_.fetch_add(charge);
+        return true;
+      }
+      std::unique_lock<std::mutex> l(spaceMtx_);
+      ++spaceWaiters_;
+      spaceCv_.wait(l, [this, charge]() { return hasRoom(charge); });
+      --spaceWaiters_;
+    }
+  }
+  /*-----------------------------------------------------
+    discard oldest queued record to make room
+    - returns false if the queue is empty or the oldest
+      record is stop, which is never taken, so it keeps
+      its ticket and its place after every earlier post
+    - evicted records count as written.  The write thread
+      publishes them once every record dequeued before them
+      is written: without lanes, after its current batch,
+      with lanes, by skipping them in the lanes' sequence
+      before the records it dequeues after counting them
+  */
+  template<Level L, typename Q>
+  bool QTestLogger<L, Q>::evictOldest() {
+    QRecord rec;
+    auto evictable = [](const QRecord& r) { return r.kind != QRecord::Kind::stop; };
+    if (!writeQ_.tryDeQIf(rec, evictable))
+      return false;
+    if (rec.charge > 0)
+      release(1, rec.charge);
+    dropped_[levelIndex(rec.level)].fetch_add(1);
+    if (rec.level == Level::results)
+      queuedResults_.fetch_sub(1);
+    evicted_.fetch_add(1);
+    return true;
+  }
+  /*-- return queue space, waking producers blocked on it --*/
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::release(size_t count, size_t bytes) {
+    if (count == 0)
+      return;
+    queuedCount_.fetch_sub(count);
+    queuedBytes_.fetch_sub(bytes);
+    if (spaceWaiters_.load() > 0) {
+      { std::lock_guard<std::mutex> l(spaceMtx_); }
+      spaceCv_.notify_all();
+    }
+  }
+  /*-----------------------------------------------------
+    append "N messages dropped" line for discards since
+    last notice
+    - reported holds per-level counts already announced
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::appendDropNotice(std::string& buffer, std::array<size_t, 4>& reported) {
+    static const char* names[] = { "results", "demo", "debug", "all" };
+    size_t total = 0;
+    std::string detail;
+    for (size_t i = 0; i < dropped_.size(); ++i) {
+      size_t count = dropped_[i].load();
+      size_t fresh = count - reported[i];
+      if (fresh == 0)
+        continue;
+      reported[i] = count;
+      total += fresh;
+      detail += detail.empty() ? " (" : ", ";
+      detail.append(names[i]).append(" ").append(std::to_string(fresh));
+    }
+    if (total == 0)
+      return;
+    buffer += this->prefix_;
+    buffer.append(std::to_string(total)).append(total == 1 ? " message" : " messages");
+    buffer.append(" dropped").append(detail).append("), write queue full");
+    buffer += this->suffix_;
+  }
+  /*-----------------------------------------------------
+    send deferred records to binary stream pBinaryStrm
+    - nullptr restores formatting them to the text streams
+    - caller owns the stream, open it std::ios::binary
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::setDeferredSink(std::ostream* pBinaryStrm) {
+    std::unique_lock<std::shared_mutex> l(this->streamsMtx_);
+    pDeferredSink_ = pBinaryStrm;
+  }
+  /*-----------------------------------------------------
+    turn fan-out mode on or off
+    - on: every stream gets its own writer thread, streams
+      lagging more than maxLagBytes are detached, 0 never
+      detaches
+    - off: waits for stream threads to write what they
+      hold, then the write thread writes streams itself,
+      streams detached while stuck in a write are left to
+      finish it alone, see SinkFanOut
+    - off closes the SinkFanOut after releasing streamsMtx_,
+      as closing reports writes, resuming completions that
+      may post, holding fanOutMtx_ so the write thread
+      can't publish to it meanwhile
+    - must not be called from a completion
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::setFanOut(bool on, size_t maxLagBytes) {
+    if (!on) {
+      std::lock_guard<std::mutex> g(fanOutMtx_);
+      std::shared_ptr<SinkFanOut> pOld;
+      {
+        std::unique_lock<std::shared_mutex> l(this->streamsMtx_);
+        pOld = std::move(pFanOut_);
+      }
+      if (pOld)
+        pOld->close();
+      return;
+    }
+    std::unique_lock<std::shared_mutex> l(this->streamsMtx_);
+    if (!pFanOut_) {
+      pFanOut_ = std::make_shared<SinkFanOut>([this](size_t count) { publishWritten(count); });
+      for (auto& sink : this->streams_)
+        pFanOut_->attach(sink.pSink, sink.pStrm, sink.format, sink.writer());
+    }
+    pFanOut_->setMaxLag(maxLagBytes);
+  }
+  /*-- progress of each stream, and lag in fan-out mode --*/
+  template<Level L, typename Q>
+  std::vector<SinkStats> QTestLogger<L, Q>::sinkStats() {
+    {
+      std::shared_lock<std::shared_mutex> l(this->streamsMtx_);
+      if (pFanOut_)
+        return pFanOut_->stats();
+    }
+    return this->sinkTotals();
+  }
+  /*-- snapshot of queue, latency, stream, and write thread statistics --*/
+  template<Level L, typename Q>
+  LoggerStats QTestLogger<L, Q>::stats() {
+    LoggerStats s;
+    size_t queued = writeQ_.enqueued();
+    size_t written = written_.load();
+    s.queueDepth = queued > written ? queued - written : 0;
+    s.highWaterDepth = static_cast<size_t>(writerCounters_.highWater.load(std::memory_order_relaxed));
+    ThreadCounters::Totals posted = postCounters_.totals();
+    s.posted = posted.posts;
+    s.postedBytes = posted.bytes;
+    s.batches = writerCounters_.batches.load(std::memory_order_relaxed);
+    s.writtenMessages = writerCounters_.messages.load(std::memory_order_relaxed);
+    s.writtenBytes = writerCounters_.bytes.load(std::memory_order_relaxed);
+    s.coalesced = writerCounters_.coalesced.load(std::memory_order_relaxed);
+    s.commits = writerCounters_.commits.load(std::memory_order_relaxed);
+    s.synced = synced_.load(std::memory_order_relaxed);
+    s.busyMicrosecs = writerCounters_.busyNs.load(std::memory_order_relaxed) / 1000.0;
+    s.idleMicrosecs = writerCounters_.idleNs.load(std::memory_order_relaxed) / 1000.0;
+    s.latency = writerCounters_.latency;
+    s.sinks = sinkStats();
+    return s;
+  }
+  /*-----------------------------------------------------
+    on a fatal signal, write unwritten messages to fds
+    - fds must stay open, the logger doesn't close them
+    - calling again replaces the descriptors
+    - writes the batch being written, some of it may have
+      reached the streams, then everything queued, read
+      with the queue's peekUnsafe, as text
+    - best effort: other threads keep running, and posts
+      held by stream threads or lanes aren't recovered
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::enableCrashFlush(const std::vector<int>& fds) {
+    disableCrashFlush();
+    keyRegistry();
+    formatRegistry();
+    pCrashOut_ = std::make_unique<CrashOutput>(fds);
+    CrashHandler::add(this);
+  }
+  /*-- stop writing messages on fatal signals --*/
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::disableCrashFlush() {
+    if (!pCrashOut_)
+      return;
+    CrashHandler::remove(this);
+    pCrashOut_.reset();
+  }
+  /*-----------------------------------------------------
+    write in-flight batch and queued records, called by
+    CrashHandler from a signal handler
+    - reads without locks, see enableCrashFlush
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::crashFlush(int signal) noexcept {
+    CrashOutput* pOut = pCrashOut_.get();
+    if (pOut == nullptr)
+      return;
+    CrashOutput& out = *pOut;
+    CrashBuffer& buf = out.buffer();
+    buf.clear();
+    buf += this->prefix_;
+    buf += "fatal signal ";
+    appendNumber(buf, signal);
+    buf += ", writing unwritten log messages";
+    buf += this->suffix_;
+    out.flush();
+    const QRecord* pBatch = crashBatch_.load();
+    size_t batchSize = crashBatchSize_.load();
+    if (pBatch != nullptr) {
+      for (size_t i = 0; i < batchSize; ++i)
+        crashWrite(out, pBatch[i]);
+    }
+    writeQ_.peekUnsafe([this, &out](const QRecord& rec) { crashWrite(out, rec); });
+    buf += this->prefix_;
+    buf += "end of unwritten log messages";
+    buf += this->suffix_;
+    buf += '\n';
+    out.flush();
+  }
+  /*-- write one record as text, without allocating --*/
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::crashWrite(CrashOutput& out, const QRecord& rec) noexcept {
+    if (rec.kind == QRecord::Kind::text) {
+      out.write(rec.text.view());
+      return;
+    }
+    if (rec.kind == QRecord::Kind::stop)
+      return;
+    CrashBuffer& buf = out.buffer();
+    buf.clear();
+    buf += this->prefix_;
+    if (rec.kind == QRecord::Kind::fields)
+      appendFieldsText(buf, rec.text.view());
+    else
+      appendFormatted(buf, rec.deferred);
+    buf += this->suffix_;
+    out.flush();
+  }
+  /*-- add stream, giving it a writer thread in fan-out mode --*/
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::addStream(std::ostream* pStrm, SinkFormat format) {
+    std::unique_lock<std::shared_mutex> l(this->streamsMtx_);
+    this->streams_.push_back(this->makeSink(pStrm, format));
+    this->updateFormats();
+    auto& sink = this->streams_.back();
+    if (pFanOut_)
+      pFanOut_->attach(sink.pSink, pStrm, format, sink.writer());
+  }
+  /*-- remove stream, first stopping its writer thread in fan-out mode --*/
+  template<Level L, typename Q>
+  bool QTestLogger<L, Q>::removeStream(std::ostream* pStrm) {
+    {
+      std::unique_lock<std::shared_mutex> l(this->streamsMtx_);
+      if (pFanOut_) {
+        for (auto& sink : this->streams_) {
+          if (sink.pStrm == pStrm)
+            pFanOut_->detach(sink.pSink);
+        }
+      }
+    }
+    return TestLogger<L>::removeStream(pStrm);
+  }
+  /*-- add native sink, giving it a writer thread in fan-out mode --*/
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::addSink(ISink* pSink, SinkFormat format) {
+    std::unique_lock<std::shared_mutex> l(this->streamsMtx_);
+    this->streams_.push_back(this->makeSink(pSink, format));
+    this->updateFormats();
+    if (pFanOut_)
+      pFanOut_->attach(pSink, nullptr, format, this->streams_.back().writer());
+  }
+  /*-- remove native sink, first stopping its writer thread in fan-out mode --*/
+  template<Level L, typename Q>
+  bool QTestLogger<L, Q>::removeSink(ISink* pSink) {
+    {
+      std::unique_lock<std::shared_mutex> l(this->streamsMtx_);
+      if (pFanOut_)
+        pFanOut_->detach(pSink);
+    }
+    return TestLogger<L>::removeSink(pSink);
+  }
   /*-- remove all streams, reset prefix and suffix --*/
-  template<Level L>
-  void QTestLogger<L>::clear() {
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::clear() {
     wait();
-    for (auto pStrm : TestLogger<L>::streams_)
-      this->removeStream(pStrm);
-    TestLogger<L>::prefix_ = "\n  ";
-    TestLogger<L>::suffix_ = "";
+    TestLogger<L>::clear();
+    publishAffixes();
+  }
+  /*-- set prefix of later posts --*/
+  template<Level L, typename Q>
+  ITestLogger<L>& QTestLogger<L, Q>::setPrefix(const std::string& prefix) {
+    TestLogger<L>::setPrefix(prefix);
+    publishAffixes();
+    return *this;
+  }
+  /*-- set suffix of later posts --*/
+  template<Level L, typename Q>
+  ITestLogger<L>& QTestLogger<L, Q>::setSuffix(const std::string& suffix) {
+    TestLogger<L>::setSuffix(suffix);
+    publishAffixes();
+    return *this;
+  }
+  /*-----------------------------------------------------
+    publish current prefix and suffix to posts
+    - reuses a kept snapshot of the same pair, so loggers
+      switching between a few pairs keep only those
+    - snapshots live until the logger is destroyed, as a
+      post may still be reading one it loaded earlier
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::publishAffixes() {
+    std::lock_guard<std::mutex> g(affixMtx_);
+    Affixes next;
+    {
+      std::shared_lock<std::shared_mutex> l(this->streamsMtx_);
+      next.prefix = this->prefix_;
+      next.suffix = this->suffix_;
+    }
+    for (auto& pKept : affixes_) {
+      if (pKept->prefix == next.prefix && pKept->suffix == next.suffix) {
+        pAffixes_.store(pKept.get(), std::memory_order_release);
+        return;
+      }
+    }
+    affixes_.push_back(std::make_unique<const Affixes>(std::move(next)));
+    pAffixes_.store(affixes_.back().get(), std::memory_order_release);
   }
   /*-- function executed by write thread --*/
-  template<Level L>
-  void QTestLogger<L>::writeThreadProc() {
-    while (true) {
-      std::string msg = writeQ_.deQ();
-      if (msg == "stop")
-        break;
-      for (auto pStrm : TestLogger<L>::streams_) {
-        (*pStrm) << msg;
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::writeThreadProc() {
+    std::vector<QRecord> batch;
+    Rendered rendered;
+    std::string notice;
+    std::string scratch;
+    std::string binBuffer;
+    std::string repeatNotice;
+    RepeatCoalescer coalescer;
+    std::vector<QRecord> incoming;
+    PriorityLanes<QRecord, 4> lanes;
+    size_t lanesDone = 0;
+    size_t evictedCounted = 0;
+    bool stopQueued = false;
+    std::vector<bool> formatsSent;
+    std::ostream* pLastSink = nullptr;
+    std::array<size_t, 4> dropsReported{};
+    size_t detachesReported = 0;
+    uint64_t busyStart = 0;
+    bool stopping = false;
+    while (!stopping) {
+      size_t maxBatch = maxBatch_.load();
+      size_t linger = lingerMicrosecs_.load();
+      uint64_t flushNs = coalesceMillisecs_.load() * 1000000;
+      Drain drain = drain_.load();
+      size_t weight = laneWeight_.load();
+      bool laned = drain != Drain::fifo || !lanes.empty() || stopQueued;
+      std::vector<QRecord>& taken = laned ? incoming : batch;
+      size_t batchUsed = batch.size();
+      batch.clear();
+      trimBatch(batch, batchUsed);
+      size_t incomingMark = evicted_.load();
+      uint64_t idleStart = steadyNanoseconds();
+      if (busyStart != 0)
+        bump(writerCounters_.busyNs, idleStart - busyStart);
+      if (!laned || (lanes.empty() && !stopQueued)) {
+        if (coalescer.pending() == 0) {
+          writeQ_.deQAll(taken, maxBatch);
+        }
+        else if (coalescer.deadline(flushNs) > idleStart) {
+          uint64_t waitNs = coalescer.deadline(flushNs) - idleStart;
+          writeQ_.deQAllFor(taken, maxBatch, std::chrono::microseconds((waitNs + 999) / 1000));
+        }
+      }
+      if (linger > 0 && taken.size() > 0 && taken.size() < maxBatch) {
+        std::this_thread::sleep_for(std::chrono::microseconds(linger));
+        writeQ_.tryDeQAll(taken, maxBatch - taken.size());
+      }
+      // counts evictions seen before mark was read, all older than incoming, then lanes incoming
+      auto addIncoming = [&](size_t mark) {
+        if (mark > evictedCounted) {
+          lanes.skip(mark - evictedCounted);
+          evictedCounted = mark;
+        }
+        for (auto& rec : incoming) {
+          size_t lane = levelIndex(rec.level);
+          if (rec.kind == QRecord::Kind::stop)
+            stopQueued = true;
+          else
+            lanes.add(std::move(rec), lane);
+        }
+        size_t used = incoming.size();
+        incoming.clear();
+        trimBatch(incoming, used);
+      };
+      // adds up to room records to batch, with lanes from everything queued,
+      // waiting up to timeout for a post, returns the count dequeued
+      auto refill = [&](size_t room, std::chrono::microseconds timeout) {
+        if (!laned) {
+          if (timeout.count() > 0)
+            return writeQ_.deQAllFor(batch, room, timeout);
+          return writeQ_.tryDeQAll(batch, room);
+        }
+        addIncoming(incomingMark);
+        incomingMark = evicted_.load();
+        size_t count = timeout.count() > 0 ?
+          writeQ_.deQAllFor(incoming, SIZE_MAX, timeout) : writeQ_.tryDeQAll(incoming);
+        addIncoming(incomingMark);
+        lanes.take(batch, room, drain, weight);
+        if (stopQueued && lanes.empty()) {
+          QRecord stopRec;
+          stopRec.kind = QRecord::Kind::stop;
+          batch.push_back(std::move(stopRec));
+          stopQueued = false;
+        }
+        return count;
+      };
+      if (laned)
+        refill(maxBatch, std::chrono::microseconds(0));
+      Durability durability = Durability::none;
+      for (auto& rec : batch)
+        durability = (std::max)(durability, rec.durability);
+      size_t commitWait = commitMicrosecs_.load();
+      if (durability == Durability::fsynced && commitWait > 0 && batch.size() < maxBatch && canSync()) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(commitWait);
+        while (batch.size() < maxBatch && !batch.empty() && batch.back().kind != QRecord::Kind::stop) {
+          auto left = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+          size_t first = batch.size();
+          if (left.count() <= 0 || refill(maxBatch - batch.size(), left) == 0)
+            break;
+          for (size_t i = first; i < batch.size(); ++i)
+            durability = (std::max)(durability, batch[i].durability);
+        }
+      }
+      busyStart = steadyNanoseconds();
+      bump(writerCounters_.idleNs, busyStart - idleStart);
+      recordDepth();
+      crashBatchSize_.store(batch.size());
+      crashBatch_.store(batch.data());
+      size_t chargedCount = 0, chargedBytes = 0;
+      for (auto& rec : batch) {
+        if (rec.charge > 0) {
+          ++chargedCount;
+          chargedBytes += rec.charge;
+        }
       }
+      release(chargedCount, chargedBytes);
+      for (auto& text : rendered)
+        text.clear();
+      binBuffer.clear();
+      size_t messages = 0;
+      bool coalescing = coalescing_.load();
+      std::unique_lock<std::mutex> fanOutLock(fanOutMtx_);
+      std::shared_lock<std::shared_mutex> l(this->streamsMtx_);
+      if (pDeferredSink_ != pLastSink) {
+        formatsSent.clear();
+        pLastSink = pDeferredSink_;
+      }
+      size_t results = 0;
+      for (auto& rec : batch) {
+        if (rec.kind == QRecord::Kind::stop) {
+          stopping = true;
+          break;
+        }
+        if (rec.level == Level::results)
+          ++results;
+        if (coalescing && coalesce(coalescer, rec, rendered, repeatNotice, busyStart))
+          continue;
+        ++messages;
+        if (rec.kind == QRecord::Kind::text) {
+          this->renderText(rendered, rec.text.view());
+        }
+        else if (rec.kind == QRecord::Kind::fields) {
+          this->renderFields(rendered, rec.text.view());
+        }
+        else if (pDeferredSink_ != nullptr) {
+          appendBinaryFrame(binBuffer, rec.deferred, formatsSent);
+        }
+        else {
+          renderDeferred(rendered, rec.deferred, scratch);
+        }
+      }
+      if (stopping || !coalescing || coalescer.due(steadyNanoseconds(), flushNs))
+        renderRepeats(coalescer, rendered, repeatNotice);
+      if (!coalescing)
+        coalescer.reset();
+      notice.clear();
+      appendDropNotice(notice, dropsReported);
+      if (binBuffer.size() > 0)
+        pDeferredSink_->write(binBuffer.data(), binBuffer.size());
+      // every record dequeued is written unless lanes hold it, so evictions are too
+      size_t count = 0;
+      if (laned) {
+        if (lanes.empty())
+          addIncoming(evicted_.load());
+        count = lanes.done() - lanesDone + (stopping ? 1 : 0);
+        lanesDone = lanes.done();
+      }
+      else {
+        size_t evicted = evicted_.load();
+        count = batch.size() + evicted - evictedCounted;
+        evictedCounted = evicted;
+      }
+      if (pFanOut_) {
+        size_t detaches = pFanOut_->detachedCount();
+        if (detaches != detachesReported) {
+          notice.append(this->prefix_).append(std::to_string(detaches - detachesReported));
+          notice.append(" stream(s) detached, too far behind").append(this->suffix_);
+          detachesReported = detaches;
+        }
+      }
+      if (notice.size() > 0)
+        this->renderText(rendered, notice);
+      size_t bytes = binBuffer.size();
+      for (auto& text : rendered)
+        bytes += text.size();
+      if (pFanOut_) {
+        SinkFanOut::Texts texts;
+        for (size_t i = 0; i < sinkFormatCount; ++i) {
+          if (rendered[i].size() > 0)
+            texts[i] = std::make_shared<const std::string>(std::move(rendered[i]));
+          rendered[i] = std::string();
+        }
+        if (durability != Durability::none)
+          commitSinks(durability);
+        std::shared_ptr<SinkFanOut> pFanOut = pFanOut_;
+        l.unlock();
+        pFanOut->publish(std::move(texts), count, durability);
+        fanOutLock.unlock();
+        queuedResults_.fetch_sub(results);
+        crashBatch_.store(nullptr);
+        recordBatch(batch, messages, bytes);
+        continue;
+      }
+      this->writeSinks(rendered, messages);
+      if (durability != Durability::none)
+        commitSinks(durability);
+      queuedResults_.fetch_sub(results);
+      crashBatch_.store(nullptr);
+      l.unlock();
+      fanOutLock.unlock();
+      recordBatch(batch, messages, bytes);
+      publishWritten(count);
     }
   }
-  /*-- write log message to all channels --*/
-  template<Level L>
-  void QTestLogger<L>::corePost(const std::string& msg) {
-    this->composite_ = this->prefix_ + msg + this->suffix_;
-    writeQ_.enQ(this->composite_);
+  /*-----------------------------------------------------
+    is rec a repeat of the previous record, if not first
+    render the previous record's pending repeat count
+    - deferred records bound for the deferred sink are
+      not compared, they never reach out
+  */
+  template<Level L, typename Q>
+  bool QTestLogger<L, Q>::coalesce(
+    RepeatCoalescer& c, const QRecord& rec, Rendered& out, std::string& scratch, uint64_t now
+  ) {
+    std::string_view bytes;
+    if (rec.kind == QRecord::Kind::deferred) {
+      if (pDeferredSink_ != nullptr)
+        return false;
+      const DeferredRecord& r = rec.deferred;
+      bytes = std::string_view(reinterpret_cast<const char*>(&r), offsetof(DeferredRecord, args) + r.size);
+    }
+    else {
+      bytes = rec.text.view();
+    }
+    if (c.repeat(static_cast<uint8_t>(rec.kind), bytes, now)) {
+      bump(writerCounters_.coalesced);
+      return true;
+    }
+    renderRepeats(c, out, scratch);
+    return false;
+  }
+  /*-- render "last message repeated N times" for pending repeats --*/
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::renderRepeats(RepeatCoalescer& c, Rendered& out, std::string& scratch) {
+    size_t count = c.take();
+    if (count == 0)
+      return;
+    scratch.clear();
+    RepeatCoalescer::appendNotice(scratch, count, this->prefix_, this->suffix_);
+    this->renderText(out, scratch);
+  }
+  /*-----------------------------------------------------
+    append deferred record to out in each format in use,
+    caller holds streamsMtx_ shared
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::renderDeferred(Rendered& out, const DeferredRecord& r, std::string& scratch) {
+    if (this->formats_ & formatBit(SinkFormat::text)) {
+      std::string& text = out[formatIndex(SinkFormat::text)];
+      text += this->prefix_;
+      appendFormatted(text, r);
+      text += this->suffix_;
+    }
+    if (this->formats_ & formatBit(SinkFormat::json)) {
+      scratch.clear();
+      appendFormatted(scratch, r);
+      appendTextJson(out[formatIndex(SinkFormat::json)], scratch);
+    }
+    if (this->formats_ & formatBit(SinkFormat::binary))
+      appendRecordFrame(out[formatIndex(SinkFormat::binary)], r);
+  }
+  /*-----------------------------------------------------
+    sample queue depth as the write thread takes a batch
+    - posts only add to the queue between drains, so its
+      deepest point is at each drain, when the taken
+      records and those still queued are all unwritten
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::recordDepth() {
+    size_t queued = writeQ_.enqueued();
+    size_t written = written_.load(std::memory_order_relaxed);
+    size_t depth = queued > written ? queued - written : 0;
+    if (depth > writerCounters_.highWater.load(std::memory_order_relaxed))
+      writerCounters_.highWater.store(depth, std::memory_order_relaxed);
+  }
+  /*-- count a written batch and record each post's latency --*/
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::recordBatch(const std::vector<QRecord>& batch, size_t messages, size_t bytes) {
+    bump(writerCounters_.batches);
+    bump(writerCounters_.messages, messages);
+    bump(writerCounters_.bytes, bytes);
+    uint64_t now = steadyNanoseconds();
+    for (auto& rec : batch) {
+      if (rec.kind != QRecord::Kind::stop)
+        writerCounters_.latency.record(now > rec.enqueuedNs ? now - rec.enqueuedNs : 0);
+    }
+  }
+  /*-----------------------------------------------------
+    shrink an emptied batch that last held used records
+    - same bound as BlockingQueue's storage, which the
+      batch swaps with, so neither keeps a burst's space
+  */
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::trimBatch(std::vector<QRecord>& batch, size_t used) {
+    size_t floor = BlockingQueue<QRecord>::retainFloor;
+    if (used == 0 || batch.capacity() <= floor || batch.capacity() <= 4 * used)
+      return;
+    std::vector<QRecord> fresh;
+    fresh.reserve(used);
+    batch.swap(fresh);
+  }
+  /*-----------------------------------------------------
+    queue prefix, msg, " : " stamp if not empty, and
+    suffix, returning its ticket
+    - takes no lock, see publishAffixes
+  */
+  template<Level L, typename Q>
+  size_t QTestLogger<L, Q>::corePost(
+    std::string_view msg, std::string_view stamp, Durability durability, Level level
+  ) {
+    const Affixes& affixes = *pAffixes_.load(std::memory_order_acquire);
+    QRecord rec;
+    rec.durability = durability;
+    size_t dated = stamp.empty() ? 0 : 3 + stamp.size();
+    rec.text.reserve(affixes.prefix.size() + msg.size() + dated + affixes.suffix.size());
+    rec.text.append(affixes.prefix).append(msg);
+    if (dated > 0)
+      rec.text.append(" : ").append(stamp);
+    rec.text.append(affixes.suffix);
+    return enQRecord(std::move(rec), level);
+  }
+  /*-----------------------------------------------------
+    queue record at level, if overflow policy admits it,
+    returns its ticket, or 0 if discarded or written by
+    this thread, see setLanes
+  */
+  template<Level L, typename Q>
+  size_t QTestLogger<L, Q>::enQRecord(QRecord&& rec, Level level) {
+    rec.level = level;
+    size_t syncDepth = syncDepth_.load(std::memory_order_relaxed);
+    if (syncDepth != 0 && level == Level::results && queuedResults_.load() == 0) {
+      size_t queued = writeQ_.enqueued();
+      size_t written = written_.load();
+      if (queued > written && queued - written > syncDepth && writeNow(rec))
+        return 0;
+    }
+    if (maxMessages_.load(std::memory_order_relaxed) != 0 ||
+      maxBytes_.load(std::memory_order_relaxed) != 0) {
+      size_t charge = sizeof(QRecord) + rec.text.size();
+      if (!admit(charge, level))
+        return 0;
+      rec.charge = charge;
+    }
+    size_t size = rec.kind == QRecord::Kind::deferred ? rec.deferred.size : rec.text.size();
+    if (level == Level::results)
+      queuedResults_.fetch_add(1);
+    rec.enqueuedNs = steadyNanoseconds();
+    size_t ticket = 0;
+    if constexpr (!allowsConcurrentDeQ<Q>::value) {
+      if (policyFor(level) != Overflow::block || inCompletion()) {
+        size_t charge = rec.charge;
+        ticket = writeQ_.tryEnQ(std::move(rec));
+        if (ticket == 0) {
+          release(charge > 0 ? 1 : 0, charge);
+          if (level == Level::results)
+            queuedResults_.fetch_sub(1);
+          dropped_[levelIndex(level)].fetch_add(1);
+          return 0;
+        }
+      }
+    }
+    if (ticket == 0)
+      ticket = writeQ_.enQ(std::move(rec));
+    postCounters_.add(size);
+    return ticket;
+  }
+  /*-----------------------------------------------------
+    write record from posting thread, with its durability
+    - returns false if it must be queued: deferred, or in
+      fan-out mode, where stream threads own the streams
+  */
+  template<Level L, typename Q>
+  bool QTestLogger<L, Q>::writeNow(const QRecord& rec) {
+    if (rec.kind == QRecord::Kind::deferred)
+      return false;
+    thread_local Rendered rendered;
+    {
+      std::shared_lock<std::shared_mutex> l(this->streamsMtx_);
+      if (pFanOut_)
+        return false;
+      for (auto& text : rendered)
+        text.clear();
+      if (rec.kind == QRecord::Kind::fields)
+        this->renderFields(rendered, rec.text.view());
+      else
+        this->renderText(rendered, rec.text.view());
+      this->writeSinks(rendered);
+      for (auto& sink : this->streams_) {
+        if (rec.durability == Durability::none)
+          break;
+        std::lock_guard<std::mutex> g(*sink.pLock);
+        applyDurability(*sink.writer(), rec.durability);
+      }
+    }
+    postCounters_.add(rec.text.size());
+    synced_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  /*-----------------------------------------------------
+    post msg, a string, MessageBuilder, or FieldRecord,
+    with durability, returning its ticket, or 0 if
+    filtered, discarded, or already written
+  */
+  template<Level L, typename Q>
+  template<typename Msg>
+  size_t QTestLogger<L, Q>::postTicket(const Msg& msg, Durability durability) {
+    if (!logLevel.enabled(L))
+      return 0;
+    if constexpr (std::is_same_v<Msg, FieldRecord>)
+      return coreFields(msg, durability);
+    else if constexpr (std::is_same_v<Msg, MessageBuilder>)
+      return corePost(msg.view(), std::string_view(), durability);
+    else
+      return corePost(std::string_view(msg), std::string_view(), durability);
+  }
+  /*-----------------------------------------------------
+    post msg, a string, MessageBuilder, or FieldRecord,
+    at level, which must be one of the levels in L
+    - lets one QTestLogger<Level::all> carry every level,
+      see setLanes
+  */
+  template<Level L, typename Q>
+  template<typename Msg>
+  ITestLogger<L>& QTestLogger<L, Q>::postAt(Level level, const Msg& msg) {
+    if ((levelValue(level) & levelValue(L)) == 0 || !logLevel.enabled(level))
+      return *this;
+    Durability durability = this->durability();
+    if constexpr (std::is_same_v<Msg, FieldRecord>)
+      coreFields(msg, durability, level);
+    else if constexpr (std::is_same_v<Msg, MessageBuilder>)
+      corePost(msg.view(), std::string_view(), durability, level);
+    else
+      corePost(std::string_view(msg), std::string_view(), durability, level);
+    return *this;
   }
   /*-- write log message to all channels --*/
-  template<Level L>
-  ITestLogger<L>& QTestLogger<L>::post(const std::string& msg) {
-    corePost(msg);
+  template<Level L, typename Q>
+  ITestLogger<L>& QTestLogger<L, Q>::post(const std::string& msg) {
+    if (!logLevel.enabled(L))
+      return *this;
+    corePost(msg, std::string_view(), durability());
     return *this;
   }
+  /*-- queue dated log message --*/
+  template<Level L, typename Q>
+  void QTestLogger<L, Q>::coreDated(std::string_view msg) {
+    char stamp[Utilities::TimestampFormatter::bufferSize];
+    size_t len = this->formatTimestamp(stamp, sizeof(stamp));
+    corePost(msg, std::string_view(stamp, len), durability());
+  }
   /*-- write dated log message to all channels --*/
-  template<Level L>
-  ITestLogger<L>& QTestLogger<L>::postDated(const std::string& msg) {
-    this->composite_ = msg + " : " + this->dt.now();
-    corePost(this->composite_);
+  template<Level L, typename Q>
+  ITestLogger<L>& QTestLogger<L, Q>::postDated(const std::string& msg) {
+    if (!logLevel.enabled(L))
+      return *this;
+    coreDated(msg);
+    return *this;
+  }
+  /*-- write built message to all channels, reading it in place --*/
+  template<Level L, typename Q>
+  ITestLogger<L>& QTestLogger<L, Q>::post(const MessageBuilder& msg) {
+    if (!logLevel.enabled(L))
+      return *this;
+    corePost(msg.view(), std::string_view(), durability());
+    return *this;
+  }
+  /*-- write dated built message to all channels --*/
+  template<Level L, typename Q>
+  ITestLogger<L>& QTestLogger<L, Q>::postDated(const MessageBuilder& msg) {
+    if (!logLevel.enabled(L))
+      return *this;
+    coreDated(msg.view());
+    return *this;
+  }
+
+  /*-- queue structured record's fields, returning its ticket --*/
+  template<Level L, typename Q>
+  size_t QTestLogger<L, Q>::coreFields(const FieldRecord& rec, Durability durability, Level level) {
+    QRecord qrec;
+    qrec.kind = QRecord::Kind::fields;
+    qrec.durability = durability;
+    qrec.text.append(rec.bytes());
+    return enQRecord(std::move(qrec), level);
+  }
+  /*-- queue structured record's fields --*/
+  template<Level L, typename Q>
+  ITestLogger<L>& QTestLogger<L, Q>::post(const FieldRecord& rec) {
+    if (!logLevel.enabled(L))
+      return *this;
+    coreFields(rec, durability());
     return *this;
   }
+  /*-- queue structured record's fields, with a time field first --*/
+  template<Level L, typename Q>
+  ITestLogger<L>& QTestLogger<L, Q>::postDated(const FieldRecord& rec) {
+    if (!logLevel.enabled(L))
+      return *this;
+    char stamp[Utilities::TimestampFormatter::bufferSize];
+    size_t len = this->formatTimestamp(stamp, sizeof(stamp));
+    QRecord qrec;
+    qrec.kind = QRecord::Kind::fields;
+    qrec.durability = durability();
+    encodeField(qrec.text, KeyRegistry::timeKey, std::string_view(stamp, len));
+    qrec.text.append(rec.bytes());
+    enQRecord(std::move(qrec));
+    return *this;
+  }
+
+  /*-----------------------------------------------------
+    queue format id and raw argument bytes
+    - formatting happens on write thread, or offline when
+      a deferred sink is set
+    - use TEST_POST_DEFERRED to register the format
+  */
+  template<Level L, typename Q>
+  template<typename... Args>
+  ITestLogger<L>& QTestLogger<L, Q>::postDeferred(FormatId id, const Args&... args) {
+    if (!logLevel.enabled(L))
+      return *this;
+    QRecord rec;
+    rec.kind = QRecord::Kind::deferred;
+    rec.durability = durability();
+    encodeArgs(rec.deferred, id, args...);
+    enQRecord(std::move(rec));
+    return *this;
+  }
+
+  /////////////////////////////////////////////////
+  // Queued logger using lock-free post queue
+
+  template<Level L = Level::all>
+  using RingQTestLogger = QTestLogger<L, MpscRingBuffer<QRecord>>;
 
   /////////////////////////////////////////////////
   // Logger factory functions
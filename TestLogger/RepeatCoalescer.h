@@ -0,0 +1,117 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// RepeatCoalescer.h - Collapse runs of identical log records          //
+// ver 1.0                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Lets a write thread replace back to back byte-identical records with
+   one "last message repeated N times" line:
+   - repeat(kind, bytes, now) compares a record with the previous one,
+     first by a 64 bit FNV-1a hash, then byte for byte, so a hash
+     collision never swallows a different message.  It returns true,
+     and counts the record, if it repeats the previous one.
+   - pending() is the count of repeats not yet reported, and due(now)
+     says whether the oldest of them has waited longer than the
+     timeout.  take() returns that count and starts a new one, still
+     comparing against the same previous record.
+   - appendNotice(out, count, prefix, suffix) formats the line.
+
+   QTestLogger::setCoalescing(on, flushMillisecs) owns one
+   RepeatCoalescer, used only by its write thread, so posting threads
+   pay nothing for it.
+
+   Dependencies:
+  ---------------
+   RepeatCoalescer.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace Test {
+
+  /////////////////////////////////////////////////////////
+  // RepeatCoalescer - write thread state of one logger
+
+  class RepeatCoalescer {
+  public:
+    bool repeat(uint8_t kind, std::string_view bytes, uint64_t nowNs);
+    size_t pending() const { return repeats_; }
+    bool due(uint64_t nowNs, uint64_t timeoutNs) const {
+      return repeats_ > 0 && nowNs - firstRepeatNs_ >= timeoutNs;
+    }
+    /*-- time at which pending repeats become due --*/
+    uint64_t deadline(uint64_t timeoutNs) const { return firstRepeatNs_ + timeoutNs; }
+    size_t take();
+    void reset();
+    static void appendNotice(
+      std::string& out, size_t count, std::string_view prefix, std::string_view suffix
+    );
+  private:
+    static uint64_t hash(std::string_view bytes);
+
+    std::string last_;
+    uint64_t lastHash_ = 0;
+    uint8_t lastKind_ = 0;
+    bool hasLast_ = false;
+    size_t repeats_ = 0;
+    uint64_t firstRepeatNs_ = 0;
+  };
+
+  /*-- FNV-1a hash of bytes --*/
+  inline uint64_t RepeatCoalescer::hash(std::string_view bytes) {
+    uint64_t h = 14695981039346656037ull;
+    for (char ch : bytes) {
+      h ^= static_cast<unsigned char>(ch);
+      h *= 1099511628211ull;
+    }
+    return h;
+  }
+  /*-----------------------------------------------------
+    does record repeat the previous one
+    - a repeat is counted, anything else becomes the
+      record later ones are compared with
+  */
+  inline bool RepeatCoalescer::repeat(uint8_t kind, std::string_view bytes, uint64_t nowNs) {
+    uint64_t h = hash(bytes);
+    if (hasLast_ && h == lastHash_ && kind == lastKind_ && bytes == last_) {
+      if (repeats_++ == 0)
+        firstRepeatNs_ = nowNs;
+      return true;
+    }
+    last_.assign(bytes.data(), bytes.size());
+    lastHash_ = h;
+    lastKind_ = kind;
+    hasLast_ = true;
+    return false;
+  }
+  /*-- pending repeat count, zeroed --*/
+  inline size_t RepeatCoalescer::take() {
+    size_t count = repeats_;
+    repeats_ = 0;
+    return count;
+  }
+  /*-- forget previous record, dropping pending repeats --*/
+  inline void RepeatCoalescer::reset() {
+    last_.clear();
+    hasLast_ = false;
+    repeats_ = 0;
+  }
+  inline void RepeatCoalescer::appendNotice(
+    std::string& out, size_t count, std::string_view prefix, std::string_view suffix
+  ) {
+    out.append(prefix);
+    out.append("last message repeated ").append(std::to_string(count));
+    out.append(count == 1 ? " time" : " times");
+    out.append(suffix);
+  }
+}
@@ -0,0 +1,436 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// SinkFanOut.h - Per-stream writer threads sharing one chunk log      //
+// ver 1.5                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   SinkFanOut lets QTestLogger write each stream from its own thread,
+   so a blocked stream, e.g., a full pipe, doesn't stall the others:
+   - publish(texts, messages, durability) appends a batch of formatted
+     messages to one shared log, rendered once for each SinkFormat in
+     use.  Texts are held by std::shared_ptr, so they are never copied
+     per stream.  Each stream writes the rendering for its own format,
+     then flushes or syncs it once if the batch's durability asks.
+   - each attached stream has a worker thread and a cursor into that
+     log.  A worker writes chunks in order, then advances its cursor.
+     Chunks every cursor has passed are released.
+   - a stream's lag is what has been published but not yet written to
+     it.  If setMaxLag(bytes, stallMillisecs) is given non-zero bytes, a
+     stream lagging more than that, and which has not finished a write
+     for stallMillisecs, is detached: its worker stops after its current
+     write and its chunks are no longer held for it.  The stall time
+     keeps a burst, published before a healthy worker gets scheduled,
+     from detaching it.  Lag is checked on each publish and by a
+     monitor thread, so a stream that stalls after the last publish
+     is still detached and can't hold up the flush barrier.
+   - a detached worker may be stuck in its sink's write for good,
+     e.g., a pipe nobody reads or a hung network mount.  detach(pSink)
+     and close() don't join such a worker.  When the SinkFanOut is
+     owned by a std::shared_ptr, they detach its std::thread instead,
+     and the worker holds the SinkFanOut alive until its write
+     returns, then exits without touching the sink again.  The sink,
+     and the stream it writes, must stay valid until then.  Without a
+     shared owner, close() can only join it.
+   - onWritten(count) is called as the slowest attached stream advances,
+     with the number of messages now written to every attached stream,
+     so QTestLogger's flush barrier keeps its meaning.  It is called
+     without SinkFanOut's lock held, so it may post or resume waiters.
+
+   Dependencies:
+  ---------------
+   SinkFanOut.h
+   LogSinks.h
+   LoggerStats.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.5 : 16 Oct 2026
+   - added close(), detached workers stuck in a write are handed off
+     instead of joined
+   ver 1.4 : 16 Oct 2026
+   - chunks carry the Durability workers apply after writing them
+   ver 1.3 : 16 Oct 2026
+   - onWritten is called after releasing mtx_
+   ver 1.2 : 16 Oct 2026
+   - chunks hold one text per SinkFormat, attach takes the stream's
+     format and the sink to write through
+   ver 1.1 : 16 Oct 2026
+   - SinkStats moved to LoggerStats.h
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include "LogSinks.h"
+#include "LoggerStats.h"
+
+namespace Test {
+
+  /////////////////////////////////////////////////////////
+  // SinkFanOut
+
+  class SinkFanOut : public std::enable_shared_from_this<SinkFanOut> {
+  public:
+    using OnWritten = std::function<void(size_t)>;
+    using Clock = std::chrono::steady_clock;
+    using Texts = std::array<std::shared_ptr<const std::string>, sinkFormatCount>;
+
+    SinkFanOut(OnWritten onWritten) : onWritten_(onWritten) {
+      monitor_ = std::thread(&SinkFanOut::monitorProc, this);
+    }
+    SinkFanOut(const SinkFanOut&) = delete;
+    SinkFanOut& operator=(const SinkFanOut&) = delete;
+    ~SinkFanOut();
+    void close();
+    void setMaxLag(size_t maxLagBytes, size_t stallMillisecs = 100);
+    void attach(
+      ISink* pSink, std::ostream* pStrm = nullptr,
+      SinkFormat format = SinkFormat::text, ISink* pOut = nullptr
+    );
+    bool detach(ISink* pSink);
+    void publish(Texts texts, size_t messages, Durability durability = Durability::none);
+    size_t detachedCount();
+    std::vector<SinkStats> stats();
+  private:
+    struct Chunk {
+      Texts texts;
+      size_t messages;
+      Durability durability;
+      size_t size(SinkFormat format) const {
+        auto& pText = texts[formatIndex(format)];
+        return pText ? pText->size() : 0;
+      }
+    };
+    struct Worker {
+      ISink* pSink = nullptr;
+      ISink* pOut = nullptr;
+      std::ostream* pStrm = nullptr;
+      SinkFormat format = SinkFormat::text;
+      size_t cursor = 0;
+      size_t doneMessages = 0;
+      size_t doneBytes = 0;
+      bool detached = false;
+      bool stop = false;
+      bool writing = false;
+      Clock::time_point lastProgress;
+      std::thread thread;
+      std::shared_ptr<SinkFanOut> pKeep;
+    };
+    void workerProc(std::shared_ptr<Worker> pWorker);
+    bool handOff(Worker& w);
+    void monitorProc();
+    void checkLag(Clock::time_point now);
+    bool isLive(const Worker& w) const { return !w.detached && !w.stop; }
+    void trim();
+    size_t advance();
+    void report(size_t count) {
+      if (count > 0)
+        onWritten_(count);
+    }
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::condition_variable monitorCv_;
+    std::deque<Chunk> log_;
+    size_t firstSeq_ = 0;
+    size_t publishedMessages_ = 0;
+    std::array<size_t, sinkFormatCount> publishedBytes_{};
+    size_t reportedMessages_ = 0;
+    size_t maxLagBytes_ = 0;
+    Clock::duration maxStall_ = std::chrono::milliseconds(100);
+    size_t detached_ = 0;
+    bool draining_ = false;
+    std::vector<std::shared_ptr<Worker>> workers_;
+    OnWritten onWritten_;
+    std::thread monitor_;
+    std::once_flag closed_;
+  };
+
+  /*-- close, if the owner hasn't --*/
+  inline SinkFanOut::~SinkFanOut() {
+    close();
+  }
+  /*-----------------------------------------------------
+    let workers finish what has been published, then join
+    them, reporting what they wrote
+    - detached workers stuck in a write are handed off,
+      see Package Responsibilities
+    - later calls wait for the first to finish
+  */
+  inline void SinkFanOut::close() {
+    std::call_once(closed_, [this]() {
+      {
+        std::lock_guard<std::mutex> l(mtx_);
+        draining_ = true;
+      }
+      cv_.notify_all();
+      monitorCv_.notify_all();
+      monitor_.join();
+      std::vector<std::shared_ptr<Worker>> joining;
+      {
+        std::lock_guard<std::mutex> l(mtx_);
+        for (auto& pWorker : workers_) {
+          if (!handOff(*pWorker))
+            joining.push_back(pWorker);
+        }
+      }
+      for (auto& pWorker : joining)
+        pWorker->thread.join();
+      size_t count;
+      {
+        std::lock_guard<std::mutex> l(mtx_);
+        workers_.clear();
+        count = advance();
+      }
+      report(count);
+    });
+  }
+  /*-----------------------------------------------------
+    let a detached worker stuck in a write finish alone,
+    caller holds mtx_
+    - returns false if w must be joined: it's live, not
+      writing, or nothing shares ownership of this
+  */
+  inline bool SinkFanOut::handOff(Worker& w) {
+    if (!w.detached || !w.writing)
+      return false;
+    w.pKeep = weak_from_this().lock();
+    if (!w.pKeep)
+      return false;
+    w.thread.detach();
+    return true;
+  }
+  /*-----------------------------------------------------
+    detach streams lagging more than maxLagBytes that
+    haven't finished a write for stallMillisecs
+    - maxLagBytes 0 never detaches
+  */
+  inline void SinkFanOut::setMaxLag(size_t maxLagBytes, size_t stallMillisecs) {
+    std::lock_guard<std::mutex> l(mtx_);
+    maxLagBytes_ = maxLagBytes;
+    maxStall_ = std::chrono::milliseconds(stallMillisecs);
+  }
+  /*-----------------------------------------------------
+    start writing pSink from the next published chunk
+    - pStrm is the stream pSink adapts, if any, reported
+      in stats
+    - the stream gets texts rendered in format, written
+      through pOut if that's not null, e.g., a wrapper
+      of pSink
+  */
+  inline void SinkFanOut::attach(ISink* pSink, std::ostream* pStrm, SinkFormat format, ISink* pOut) {
+    std::lock_guard<std::mutex> l(mtx_);
+    auto pWorker = std::make_shared<Worker>();
+    pWorker->pSink = pSink;
+    pWorker->pOut = pOut != nullptr ? pOut : pSink;
+    pWorker->pStrm = pStrm;
+    pWorker->format = format;
+    pWorker->cursor = firstSeq_ + log_.size();
+    pWorker->doneMessages = publishedMessages_;
+    pWorker->doneBytes = publishedBytes_[formatIndex(format)];
+    pWorker->lastProgress = Clock::now();
+    pWorker->thread = std::thread(&SinkFanOut::workerProc, this, pWorker);
+    workers_.push_back(std::move(pWorker));
+  }
+  /*-----------------------------------------------------
+    stop writing pSink, discarding chunks it hasn't written
+    - waits for a write in progress, so pSink may be
+      closed once this returns, unless pSink was detached
+      for lagging while stuck in that write, see handOff
+  */
+  inline bool SinkFanOut::detach(ISink* pSink) {
+    std::unique_lock<std::mutex> l(mtx_);
+    auto iter = std::find_if(workers_.begin(), workers_.end(),
+      [pSink](const std::shared_ptr<Worker>& w) { return w->pSink == pSink; });
+    if (iter == workers_.end())
+      return false;
+    std::shared_ptr<Worker> pWorker = *iter;
+    pWorker->stop = true;
+    if (!handOff(*pWorker)) {
+      l.unlock();
+      cv_.notify_all();
+      pWorker->thread.join();
+      l.lock();
+    }
+    workers_.erase(std::find(workers_.begin(), workers_.end(), pWorker));
+    trim();
+    size_t count = advance();
+    l.unlock();
+    report(count);
+    return true;
+  }
+  /*-----------------------------------------------------
+    append chunk holding messages formatted messages,
+    texts holds their rendering in each format in use,
+    and durability what workers apply after writing it
+    - never waits for streams
+    - detaches streams now lagging past maxLagBytes and
+      stalled, see setMaxLag
+  */
+  inline void SinkFanOut::publish(Texts texts, size_t messages, Durability durability) {
+    size_t count;
+    {
+      std::lock_guard<std::mutex> l(mtx_);
+      Clock::time_point now = Clock::now();
+      size_t end = firstSeq_ + log_.size();
+      for (auto& pWorker : workers_) {
+        if (pWorker->cursor == end)
+          pWorker->lastProgress = now;
+      }
+      Chunk chunk{ std::move(texts), messages, durability };
+      publishedMessages_ += messages;
+      for (size_t i = 0; i < sinkFormatCount; ++i)
+        publishedBytes_[i] += chunk.size(static_cast<SinkFormat>(i));
+      log_.push_back(std::move(chunk));
+      checkLag(now);
+      trim();
+      count = advance();
+    }
+    cv_.notify_all();
+    report(count);
+  }
+  /*-- number of streams detached for lagging --*/
+  inline size_t SinkFanOut::detachedCount() {
+    std::lock_guard<std::mutex> l(mtx_);
+    return detached_;
+  }
+  /*-- progress and lag of each attached stream --*/
+  inline std::vector<SinkStats> SinkFanOut::stats() {
+    std::lock_guard<std::mutex> l(mtx_);
+    std::vector<SinkStats> result;
+    for (auto& pWorker : workers_) {
+      SinkStats s;
+      s.pSink = pWorker->pSink;
+      s.pStrm = pWorker->pStrm;
+      s.writtenMessages = pWorker->doneMessages;
+      s.writtenBytes = pWorker->doneBytes;
+      s.lagMessages = publishedMessages_ - pWorker->doneMessages;
+      s.lagBytes = publishedBytes_[formatIndex(pWorker->format)] - pWorker->doneBytes;
+      s.detached = pWorker->detached;
+      result.push_back(s);
+    }
+    return result;
+  }
+  /*-- release chunks every live cursor has passed, caller holds mtx_ --*/
+  inline void SinkFanOut::trim() {
+    size_t minCursor = firstSeq_ + log_.size();
+    for (auto& pWorker : workers_) {
+      if (isLive(*pWorker))
+        minCursor = (std::min)(minCursor, pWorker->cursor);
+    }
+    while (firstSeq_ < minCursor) {
+      log_.pop_front();
+      ++firstSeq_;
+    }
+  }
+  /*-- detach lagging, stalled streams, caller holds mtx_ --*/
+  inline void SinkFanOut::checkLag(Clock::time_point now) {
+    if (maxLagBytes_ == 0)
+      return;
+    for (auto& pWorker : workers_) {
+      if (!isLive(*pWorker) || publishedBytes_[formatIndex(pWorker->format)] - pWorker->doneBytes <= maxLagBytes_)
+        continue;
+      if (now - pWorker->lastProgress > maxStall_) {
+        pWorker->detached = true;
+        ++detached_;
+      }
+    }
+  }
+  /*-- checks lag every half stall time, between publishes --*/
+  inline void SinkFanOut::monitorProc() {
+    std::unique_lock<std::mutex> l(mtx_);
+    while (!draining_) {
+      monitorCv_.wait_for(l, maxStall_ / 2);
+      size_t detached = detached_;
+      checkLag(Clock::now());
+      if (detached_ != detached) {
+        trim();
+        size_t count = advance();
+        cv_.notify_all();
+        l.unlock();
+        report(count);
+        l.lock();
+      }
+    }
+  }
+  /*-----------------------------------------------------
+    count of messages newly written to every live stream,
+    caller holds mtx_, and reports it after unlocking
+  */
+  inline size_t SinkFanOut::advance() {
+    size_t written = publishedMessages_;
+    for (auto& pWorker : workers_) {
+      if (isLive(*pWorker))
+        written = (std::min)(written, pWorker->doneMessages);
+    }
+    if (written <= reportedMessages_)
+      return 0;
+    size_t count = written - reportedMessages_;
+    reportedMessages_ = written;
+    return count;
+  }
+  /*-----------------------------------------------------
+    worker thread, one per stream
+    - writes each chunk outside the lock, holding its own
+      reference so trim() can't free it mid-write
+    - when draining, exits once caught up
+    - once detached, never touches its sink again, and if
+      handed off, releases the SinkFanOut as it exits
+  */
+  inline void SinkFanOut::workerProc(std::shared_ptr<Worker> pWorker) {
+    std::unique_lock<std::mutex> l(mtx_);
+    while (true) {
+      cv_.wait(l, [this, &pWorker]() {
+        return !isLive(*pWorker) || draining_ || pWorker->cursor < firstSeq_ + log_.size();
+      });
+      if (!isLive(*pWorker))
+        break;
+      if (pWorker->cursor == firstSeq_ + log_.size())
+        break;
+      Chunk chunk = log_[pWorker->cursor - firstSeq_];
+      size_t size = chunk.size(pWorker->format);
+      pWorker->writing = true;
+      l.unlock();
+      if (size > 0)
+        pWorker->pOut->write(*chunk.texts[formatIndex(pWorker->format)]);
+      if (size > 0 && chunk.durability != Durability::none) {
+        l.lock();
+        bool live = isLive(*pWorker);
+        l.unlock();
+        if (live)
+          applyDurability(*pWorker->pOut, chunk.durability);
+      }
+      l.lock();
+      pWorker->writing = false;
+      if (!isLive(*pWorker))
+        break;
+      ++pWorker->cursor;
+      pWorker->doneMessages += chunk.messages;
+      pWorker->doneBytes += size;
+      pWorker->lastProgress = Clock::now();
+      trim();
+      size_t count = advance();
+      if (count > 0) {
+        l.unlock();
+        report(count);
+        l.lock();
+      }
+    }
+    std::shared_ptr<SinkFanOut> pKeep = std::move(pWorker->pKeep);
+    l.unlock();
+  }
+}
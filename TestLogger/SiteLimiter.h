@@ -0,0 +1,306 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// SiteLimiter.h - Per-call-site sampling and rate limiting            //
+// ver 1.1                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Limits how often one logging statement posts, for debug lines in
+   hot loops:
+     TEST_POST_EVERY_N(logger, 1000, "iteration " + std::to_string(i));
+     TEST_POST_RATE(logger, 10, "retrying " + name);
+     TEST_POST_FIRST_N(logger, 5, 100, MessageBuilder() << "slow " << ms);
+   - Limit describes the policy:
+     - everyN(n):        the first of every n occurrences counted
+                         by each shard, see below, posts
+     - perSecond(k):     at most k posts in each clock second
+     - firstN(n, every): the first n occurrences post, then one of
+                         every occurrences per shard, 0 for none
+   - SiteLimiter holds one site's state.  The macros create one static
+     SiteLimiter per site, next to its CallSite, see ITestLogger.h.
+     admit() decides before the message is built, so suppressed posts
+     never format their message or touch a logger's queue.
+   - counters live in 16 cache-line sized shards.  Threads are given
+     shards round robin, so a shard is shared only when more than 16
+     threads hit the site, and sampling counts per shard, not per
+     thread.  Over its limit, a perSecond site only reads the shared
+     window.
+   - takeSummary() returns occurrences suppressed since the last
+     summary, at most once per Limit::summaryMillisecs, and the macros
+     post it as "file:line  suppressed N occurrences of format".  Any
+     hit of the site may take it, admitted or not, though a busy
+     shard's suppressed hits only look every summaryCheck occurrences.
+   - siteLimiters() lists every limiter, with the logger its site last
+     posted to.  takePending(logger) collects the counts no summary has
+     reported yet, which postPendingSummaries(logger), ITestLogger.h,
+     posts, and QTestLogger does at wait() and when destroyed, so a
+     site that stops posting still reports its last window.
+
+   Dependencies:
+  ---------------
+   SiteLimiter.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.1 : 16 Oct 2026
+   - summaries are taken on suppressed hits too, and reported when a
+     QTestLogger waits or is destroyed
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace Test {
+
+  class CallSite;  // see CallSite.h
+
+  /////////////////////////////////////////////////////////
+  // Limit - sampling or rate policy of one site
+
+  struct Limit {
+    enum class Kind : uint8_t { everyN, perSecond, firstN };
+    Kind kind = Kind::everyN;
+    uint64_t count = 1;
+    uint64_t every = 1;
+    uint64_t summaryMillisecs = 1000;
+
+    static Limit everyN(uint64_t n) {
+      Limit l;
+      l.kind = Kind::everyN;
+      l.every = n > 0 ? n : 1;
+      return l;
+    }
+    static Limit perSecond(uint64_t k) {
+      Limit l;
+      l.kind = Kind::perSecond;
+      l.count = k;
+      return l;
+    }
+    static Limit firstN(uint64_t n, uint64_t every) {
+      Limit l;
+      l.kind = Kind::firstN;
+      l.count = n;
+      l.every = every;
+      return l;
+    }
+  };
+
+  /////////////////////////////////////////////////////////
+  // SiteLimiter - admission state of one call site
+
+  class SiteLimiter {
+  public:
+    static constexpr size_t shardCount = 16;
+    static constexpr uint64_t summaryCheck = 64;
+
+    explicit SiteLimiter(const Limit& limit, const CallSite* pSite = nullptr);
+    ~SiteLimiter();
+    SiteLimiter(const SiteLimiter&) = delete;
+    SiteLimiter& operator=(const SiteLimiter&) = delete;
+
+    bool admit();
+    uint64_t suppressed() const;
+    uint64_t takeSummary(bool admitted = true, const void* pLogger = nullptr);
+    uint64_t takePending();
+    const CallSite* site() const { return pSite_; }
+    const void* logger() const { return pLogger_.load(std::memory_order_relaxed); }
+  private:
+    static constexpr unsigned countBits = 24;
+    static constexpr uint64_t countMask = (uint64_t(1) << countBits) - 1;
+
+    struct alignas(64) Shard {
+      std::atomic<uint64_t> seen{ 0 };
+      std::atomic<uint64_t> suppressed{ 0 };
+    };
+
+    static uint64_t nowNanoseconds() {
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+      ).count());
+    }
+    /*-- calling thread's shard, assigned round robin --*/
+    Shard& shard() {
+      static std::atomic<size_t> nextIndex{ 0 };
+      thread_local size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % shardCount;
+      return shards_[index];
+    }
+    bool sample(Shard& s, uint64_t every);
+    bool withinRate();
+    bool suppress(Shard& s) {
+      s.suppressed.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    uint64_t claim(uint64_t total);
+
+    Limit limit_;
+    const CallSite* pSite_;
+    std::atomic<const void*> pLogger_{ nullptr };
+    std::array<Shard, shardCount> shards_;
+    alignas(64) std::atomic<uint64_t> window_{ 0 };
+    std::atomic<uint64_t> first_{ 0 };
+    std::atomic<uint64_t> reported_{ 0 };
+    std::atomic<uint64_t> lastSummaryNs_{ 0 };
+  };
+
+  /////////////////////////////////////////////////////////
+  // SiteLimiterRegistry - every live SiteLimiter
+
+  class SiteLimiterRegistry {
+  public:
+    using Pending = std::pair<const CallSite*, uint64_t>;
+
+    void add(SiteLimiter* pLimiter);
+    void remove(SiteLimiter* pLimiter);
+    std::vector<Pending> takePending(const void* pLogger);
+  private:
+    std::mutex mtx_;
+    std::vector<SiteLimiter*> limiters_;
+  };
+
+  /*-- never destroyed, so loggers destroyed at exit can still use it --*/
+  inline SiteLimiterRegistry& siteLimiters() {
+    static SiteLimiterRegistry* pRegistry = new SiteLimiterRegistry;
+    return *pRegistry;
+  }
+
+  inline SiteLimiter::SiteLimiter(const Limit& limit, const CallSite* pSite)
+    : limit_(limit), pSite_(pSite) {
+    if (limit_.kind == Limit::Kind::perSecond && limit_.count > countMask)
+      limit_.count = countMask;
+    lastSummaryNs_.store(nowNanoseconds(), std::memory_order_relaxed);
+    siteLimiters().add(this);
+  }
+  inline SiteLimiter::~SiteLimiter() {
+    siteLimiters().remove(this);
+  }
+
+  /*-- should this occurrence post, counting it if not --*/
+  inline bool SiteLimiter::admit() {
+    Shard& s = shard();
+    switch (limit_.kind) {
+    case Limit::Kind::everyN:
+      return sample(s, limit_.every) || suppress(s);
+    case Limit::Kind::perSecond:
+      return withinRate() || suppress(s);
+    case Limit::Kind::firstN:
+      if (first_.load(std::memory_order_relaxed) < limit_.count &&
+        first_.fetch_add(1, std::memory_order_relaxed) < limit_.count)
+        return true;
+      return (limit_.every > 0 && sample(s, limit_.every)) || suppress(s);
+    }
+    return true;
+  }
+  /*-- first of every occurrences seen by this shard --*/
+  inline bool SiteLimiter::sample(Shard& s, uint64_t every) {
+    return s.seen.fetch_add(1, std::memory_order_relaxed) % every == 0;
+  }
+  /*-----------------------------------------------------
+    take one of this second's posts, if any are left
+    - window_ packs the second in the high bits and the
+      posts taken in it in the low countBits
+  */
+  inline bool SiteLimiter::withinRate() {
+    uint64_t second = nowNanoseconds() / 1000000000;
+    uint64_t state = window_.load(std::memory_order_relaxed);
+    while (true) {
+      uint64_t desired;
+      if ((state >> countBits) == second) {
+        if ((state & countMask) >= limit_.count)
+          return false;
+        desired = state + 1;
+      }
+      else {
+        if (limit_.count == 0)
+          return false;
+        desired = (second << countBits) | 1;
+      }
+      if (window_.compare_exchange_weak(state, desired, std::memory_order_relaxed))
+        return true;
+    }
+  }
+  /*-- occurrences suppressed so far --*/
+  inline uint64_t SiteLimiter::suppressed() const {
+    uint64_t total = 0;
+    for (auto& s : shards_)
+      total += s.suppressed.load(std::memory_order_relaxed);
+    return total;
+  }
+  /*-----------------------------------------------------
+    occurrences suppressed since last summary, or 0 if
+    there are none or one was taken too recently
+    - called on every hit, admitted says whether this one
+      posts, pLogger is the logger it posts to
+    - a suppressed hit only reads the clock while its
+      shard has suppressed few occurrences, or every
+      summaryCheck occurrences after that
+    - only one of several racing threads gets the count
+  */
+  inline uint64_t SiteLimiter::takeSummary(bool admitted, const void* pLogger) {
+    if (pLogger != nullptr && pLogger_.load(std::memory_order_relaxed) != pLogger)
+      pLogger_.store(pLogger, std::memory_order_relaxed);
+    if (!admitted) {
+      uint64_t count = shard().suppressed.load(std::memory_order_relaxed);
+      if (count > summaryCheck && count % summaryCheck != 0)
+        return 0;
+    }
+    uint64_t now = nowNanoseconds();
+    uint64_t last = lastSummaryNs_.load(std::memory_order_relaxed);
+    if (now - last < limit_.summaryMillisecs * 1000000)
+      return 0;
+    uint64_t total = suppressed();
+    if (total <= reported_.load(std::memory_order_relaxed))
+      return 0;
+    if (!lastSummaryNs_.compare_exchange_strong(last, now, std::memory_order_relaxed))
+      return 0;
+    return claim(total);
+  }
+  /*-- occurrences suppressed and not yet reported, however recent the last summary --*/
+  inline uint64_t SiteLimiter::takePending() {
+    return claim(suppressed());
+  }
+  /*-- move reported_ up to total, returning the occurrences this caller reports --*/
+  inline uint64_t SiteLimiter::claim(uint64_t total) {
+    uint64_t reported = reported_.load(std::memory_order_relaxed);
+    while (reported < total) {
+      if (reported_.compare_exchange_weak(reported, total, std::memory_order_relaxed))
+        return total - reported;
+    }
+    return 0;
+  }
+
+  //----< SiteLimiterRegistry >------------------------------------------
+
+  inline void SiteLimiterRegistry::add(SiteLimiter* pLimiter) {
+    std::lock_guard<std::mutex> l(mtx_);
+    limiters_.push_back(pLimiter);
+  }
+  inline void SiteLimiterRegistry::remove(SiteLimiter* pLimiter) {
+    std::lock_guard<std::mutex> l(mtx_);
+    limiters_.erase(std::remove(limiters_.begin(), limiters_.end(), pLimiter), limiters_.end());
+  }
+  /*-----------------------------------------------------
+    unreported counts of sites that last posted to
+    pLogger, claimed so no later summary repeats them
+  */
+  inline std::vector<SiteLimiterRegistry::Pending> SiteLimiterRegistry::takePending(const void* pLogger) {
+    std::vector<Pending> pending;
+    std::lock_guard<std::mutex> l(mtx_);
+    for (auto pLimiter : limiters_) {
+      if (pLimiter->site() == nullptr || pLimiter->logger() != pLogger)
+        continue;
+      if (uint64_t count = pLimiter->takePending())
+        pending.push_back(Pending{ pLimiter->site(), count });
+    }
+    return pending;
+  }
+}
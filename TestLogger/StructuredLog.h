@@ -0,0 +1,712 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////////
+// StructuredLog.h - Typed key-value log records                       //
+// ver 1.2                                                             //
+// Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
+/////////////////////////////////////////////////////////////////////////
+/*
+   Package Responsibilities:
+  ---------------------------
+   Supports posting records of typed fields instead of opaque text:
+     logger.post(FieldRecord("request done")
+       << TEST_FIELD("status", 200) << TEST_FIELD("path", path));
+   - registerKey(name) interns a field name, returning a KeyId.
+     TEST_FIELD(name, value) registers its name once per call site,
+     and a Key object does the same for a name used in many places.
+     Keys "msg" and "time" are predefined.
+   - FieldRecord encodes fields as they are added, as key id, type
+     tag, and raw value bytes, into a LogRecord, so no text is built
+     on the posting thread and small records never allocate.
+     Fields may be bool, char, integers, enums, floating point, or
+     anything convertible to std::string_view.
+   - loggers render records for each sink by its SinkFormat:
+     - text:   msg key=value key="quoted value" ...
+     - json:   {"msg":"...","key":value,...} one object per line
+     - binary: 'S' frames holding the encoded fields
+     Plain text posts render as {"msg":"..."} and 'T' frames.
+   - BinaryLogSink wraps a sink, writing each key name and deferred
+     format string to it once, in 'K' and 'F' frames, just before the
+     first frame that uses it.  Loggers wrap every binary sink, so a
+     record's bytes are the same for all sinks.
+   - decodeLog(in, out, format) expands a binary log as text or JSON.
+
+   Binary log layout, native byte order:
+     'K' uint16 keyId, uint16 length, name chars
+     'S' uint32 size, fields
+     'T' uint32 size, text
+     'F' and 'R' frames as in DeferredLog.h
+   Field layout:
+     uint16 keyId, tag, value - tags as in DeferredLog.h, except that
+     string lengths are uint32
+
+   Dependencies:
+  ---------------
+   StructuredLog.h
+   DeferredLog.h
+   LogRecord.h
+   LogSinks.h
+
+   Maintenance History:
+  ----------------------
+   ver 1.2 : 16 Oct 2026
+   - BinaryLogSink forwards sync and canSync
+   ver 1.1 : 16 Oct 2026
+   - text renderers take any output buffer, see CrashFlush.h
+   ver 1.0 : 16 Oct 2026
+   - first release
+*/
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include <charconv>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <type_traits>
+#include "DeferredLog.h"
+#include "LogRecord.h"
+#include "LogSinks.h"
+
+namespace Test {
+
+  using KeyId = uint16_t;
+
+  /////////////////////////////////////////////////////////
+  // KeyRegistry
+  // - fixed table, so writer lookups need no lock
+  // - names must outlive the process' logging, normally
+  //   they are string literals
+
+  class KeyRegistry {
+  public:
+    static constexpr size_t maxKeys = 1024;
+    static constexpr KeyId invalidId = UINT16_MAX;
+    static constexpr KeyId msgKey = 0;
+    static constexpr KeyId timeKey = 1;
+
+    KeyRegistry() {
+      add("msg");
+      add("time");
+    }
+    /*-- id of name, registering it if it's new --*/
+    KeyId add(const char* name) {
+      std::lock_guard<std::mutex> l(mtx_);
+      size_t count = count_.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < count; ++i) {
+        if (std::strcmp(names_[i].load(std::memory_order_relaxed), name) == 0)
+          return static_cast<KeyId>(i);
+      }
+      if (count >= maxKeys)
+        return invalidId;
+      names_[count].store(name, std::memory_order_relaxed);
+      count_.store(count + 1, std::memory_order_release);
+      return static_cast<KeyId>(count);
+    }
+    const char* find(KeyId id) const {
+      if (id >= count_.load(std::memory_order_acquire))
+        return nullptr;
+      return names_[id].load(std::memory_order_relaxed);
+    }
+  private:
+    std::array<std::atomic<const char*>, maxKeys> names_{};
+    std::atomic<size_t> count_{ 0 };
+    std::mutex mtx_;
+  };
+
+  inline KeyRegistry& keyRegistry() {
+    static KeyRegistry registry;
+    return registry;
+  }
+
+  inline KeyId registerKey(const char* name) {
+    return keyRegistry().add(name);
+  }
+
+  /*-- registered name of id, "?" if unknown --*/
+  inline std::string_view keyName(KeyId id) {
+    const char* name = keyRegistry().find(id);
+    return name != nullptr ? std::string_view(name) : std::string_view("?");
+  }
+
+  /////////////////////////////////////////////////////////
+  // Field and Key
+  // - a Field refers to its value, so use it within the
+  //   expression that creates it
+
+  template<typename T>
+  struct Field {
+    KeyId key;
+    const T& value;
+  };
+
+  template<typename T>
+  inline Field<T> makeField(KeyId key, const T& value) {
+    return Field<T>{ key, value };
+  }
+
+  class Key {
+  public:
+    explicit Key(const char* name) : id_(registerKey(name)) {}
+    KeyId id() const { return id_; }
+    template<typename T>
+    Field<T> operator()(const T& value) const {
+      return Field<T>{ id_, value };
+    }
+  private:
+    KeyId id_;
+  };
+
+  /*-- append key, tag, and value bytes --*/
+  template<typename T>
+  inline void appendField(LogRecord& out, KeyId key, char tag, T value) {
+    char bytes[sizeof(KeyId) + 1 + sizeof(T)];
+    std::memcpy(bytes, &key, sizeof(KeyId));
+    bytes[sizeof(KeyId)] = tag;
+    std::memcpy(bytes + sizeof(KeyId) + 1, &value, sizeof(T));
+    out.append(bytes, sizeof(bytes));
+  }
+
+  /*-----------------------------------------------------
+    encode one field
+    - fields with unregistered keys, e.g., from a full
+      registry, are skipped
+  */
+  template<typename T>
+  inline void encodeField(LogRecord& out, KeyId key, const T& value) {
+    using U = std::decay_t<T>;
+    if (key == KeyRegistry::invalidId)
+      return;
+    if constexpr (std::is_same_v<U, bool>) {
+      appendField(out, key, 'b', static_cast<uint8_t>(value));
+    }
+    else if constexpr (std::is_same_v<U, char>) {
+      appendField(out, key, 'c', value);
+    }
+    else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+      appendField(out, key, 'i', static_cast<int64_t>(value));
+    }
+    else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>) {
+      appendField(out, key, 'u', static_cast<uint64_t>(value));
+    }
+    else if constexpr (std::is_floating_point_v<U>) {
+      appendField(out, key, 'd', static_cast<double>(value));
+    }
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+      std::string_view sv(value);
+      appendField(out, key, 's', static_cast<uint32_t>(sv.size()));
+      out.append(sv);
+    }
+    else {
+      static_assert(dependent_false<U>::value, "unsupported log field type");
+    }
+  }
+
+  /////////////////////////////////////////////////////////
+  // FieldRecord - fields of one structured post
+
+  class FieldRecord {
+  public:
+    FieldRecord() {}
+    explicit FieldRecord(std::string_view msg) {
+      encodeField(fields_, KeyRegistry::msgKey, msg);
+    }
+    template<typename T>
+    FieldRecord& add(KeyId key, const T& value) {
+      encodeField(fields_, key, value);
+      return *this;
+    }
+    template<typename T>
+    FieldRecord& add(const Field<T>& field) {
+      return add(field.key, field.value);
+    }
+    template<typename T>
+    FieldRecord& operator<<(const Field<T>& field) {
+      return add(field.key, field.value);
+    }
+    std::string_view bytes() const { return fields_.view(); }
+    size_t size() const { return fields_.size(); }
+    bool empty() const { return fields_.empty(); }
+    void clear() { fields_.clear(); }
+    std::string toString() const;
+  private:
+    LogRecord fields_;
+  };
+
+  /////////////////////////////////////////////////////////
+  // Reading encoded fields
+
+  struct FieldValue {
+    KeyId key = KeyRegistry::invalidId;
+    char tag = 0;
+    int64_t i = 0;
+    uint64_t u = 0;
+    double d = 0.0;
+    std::string_view s;
+  };
+
+  template<typename T>
+  inline bool readBytes(std::string_view bytes, size_t& pos, T& value) {
+    if (pos + sizeof(T) > bytes.size())
+      return false;
+    std::memcpy(&value, bytes.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  /*-- decode field at pos, returns false at end or on bad bytes --*/
+  inline bool nextField(std::string_view bytes, size_t& pos, FieldValue& f) {
+    if (!readBytes(bytes, pos, f.key) || !readBytes(bytes, pos, f.tag))
+      return false;
+    switch (f.tag) {
+    case 'b': {
+      uint8_t v;
+      if (!readBytes(bytes, pos, v))
+        return false;
+      f.u = v;
+      return true;
+    }
+    case 'c': {
+      char v;
+      if (!readBytes(bytes, pos, v))
+        return false;
+      f.u = static_cast<unsigned char>(v);
+      return true;
+    }
+    case 'i':
+      return readBytes(bytes, pos, f.i);
+    case 'u':
+      return readBytes(bytes, pos, f.u);
+    case 'd':
+      return readBytes(bytes, pos, f.d);
+    case 's': {
+      uint32_t len;
+      if (!readBytes(bytes, pos, len) || pos + len > bytes.size())
+        return false;
+      f.s = bytes.substr(pos, len);
+      pos += len;
+      return true;
+    }
+    default:
+      return false;
+    }
+  }
+
+  /////////////////////////////////////////////////////////
+  // Rendering
+  // - NameOf maps a KeyId to its name, keyName by default,
+  //   decodeLog uses the names read from the log
+  // - text renderers take any Out with append(p, n) and
+  //   operator+= for char and C strings, see CrashFlush.h
+
+  /*-- text without leading and trailing whitespace --*/
+  inline std::string_view trimText(std::string_view text) {
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string_view::npos)
+      return std::string_view();
+    size_t last = text.find_last_not_of(" \t\r\n");
+    return text.substr(first, last - first + 1);
+  }
+
+  /*-- append text as quoted JSON string --*/
+  template<typename Out>
+  inline void appendJsonString(Out& out, std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    size_t run = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+      unsigned char ch = static_cast<unsigned char>(text[i]);
+      if (ch >= 0x20 && ch != '"' && ch != '\\')
+        continue;
+      out.append(text.data() + run, i - run);
+      run = i + 1;
+      switch (ch) {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        out += "\\u00";
+        out += hex[ch >> 4];
+        out += hex[ch & 0xf];
+      }
+    }
+    out.append(text.data() + run, text.size() - run);
+    out += '"';
+  }
+
+  /*-- append number with std::to_chars --*/
+  template<typename Out, typename T>
+  inline void appendNumber(Out& out, T value) {
+    char buf[32];
+    auto res = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, static_cast<size_t>(res.ptr - buf));
+  }
+
+  /*-- does text need quotes to read back as one value --*/
+  inline bool needsQuotes(std::string_view text) {
+    if (text.empty())
+      return true;
+    for (char ch : text) {
+      if (static_cast<unsigned char>(ch) <= ' ' || ch == '"' || ch == '=' || ch == '\\')
+        return true;
+    }
+    return false;
+  }
+
+  /*-- append field's value as text, strings quoted only if quote --*/
+  template<typename Out>
+  inline void appendValueText(Out& out, const FieldValue& f, bool quote) {
+    switch (f.tag) {
+    case 'b': out += f.u ? "true" : "false"; break;
+    case 'c': out += static_cast<char>(f.u); break;
+    case 'i': appendNumber(out, f.i); break;
+    case 'u': appendNumber(out, f.u); break;
+    case 'd': appendNumber(out, f.d); break;
+    case 's':
+      if (quote && needsQuotes(f.s))
+        appendJsonString(out, f.s);
+      else
+        out.append(f.s.data(), f.s.size());
+      break;
+    }
+  }
+
+  /*-- append field's value as JSON --*/
+  inline void appendValueJson(std::string& out, const FieldValue& f) {
+    switch (f.tag) {
+    case 'b': out += f.u ? "true" : "false"; break;
+    case 'c': {
+      char ch = static_cast<char>(f.u);
+      appendJsonString(out, std::string_view(&ch, 1));
+      break;
+    }
+    case 'i': appendNumber(out, f.i); break;
+    case 'u': appendNumber(out, f.u); break;
+    case 'd':
+      if (std::isfinite(f.d))
+        appendNumber(out, f.d);
+      else
+        out += "null";
+      break;
+    case 's': appendJsonString(out, f.s); break;
+    }
+  }
+
+  /*-----------------------------------------------------
+    append fields as text: values of msg and time bare,
+    other fields as key=value, separated by spaces
+  */
+  template<typename Out, typename NameOf>
+  inline void appendFieldsText(Out& out, std::string_view fields, NameOf nameOf) {
+    size_t pos = 0;
+    FieldValue f;
+    bool first = true;
+    while (nextField(fields, pos, f)) {
+      if (!first)
+        out += ' ';
+      first = false;
+      if (f.key == KeyRegistry::msgKey || f.key == KeyRegistry::timeKey) {
+        appendValueText(out, f, false);
+        continue;
+      }
+      std::string_view name = nameOf(f.key);
+      out.append(name.data(), name.size());
+      out += '=';
+      appendValueText(out, f, true);
+    }
+  }
+
+  template<typename Out>
+  inline void appendFieldsText(Out& out, std::string_view fields) {
+    appendFieldsText(out, fields, keyName);
+  }
+
+  /*-- append fields as one JSON object and newline --*/
+  template<typename NameOf>
+  inline void appendFieldsJson(std::string& out, std::string_view fields, NameOf nameOf) {
+    size_t pos = 0;
+    FieldValue f;
+    out += '{';
+    bool first = true;
+    while (nextField(fields, pos, f)) {
+      if (!first)
+        out += ',';
+      first = false;
+      appendJsonString(out, nameOf(f.key));
+      out += ':';
+      appendValueJson(out, f);
+    }
+    out += "}\n";
+  }
+
+  inline void appendFieldsJson(std::string& out, std::string_view fields) {
+    appendFieldsJson(out, fields, keyName);
+  }
+
+  /*-- append plain text post as JSON object with only a msg --*/
+  inline void appendTextJson(std::string& out, std::string_view text) {
+    out += "{\"msg\":";
+    appendJsonString(out, trimText(text));
+    out += "}\n";
+  }
+
+  inline std::string FieldRecord::toString() const {
+    std::string text;
+    appendFieldsText(text, bytes());
+    return text;
+  }
+
+  /////////////////////////////////////////////////////////
+  // Binary frames
+
+  template<typename T>
+  inline void appendRaw(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  inline void appendKeyFrame(std::string& out, KeyId id, std::string_view name) {
+    out += 'K';
+    appendRaw(out, id);
+    appendRaw(out, static_cast<uint16_t>(name.size()));
+    out.append(name.data(), name.size());
+  }
+
+  inline void appendFieldsFrame(std::string& out, std::string_view fields) {
+    out += 'S';
+    appendRaw(out, static_cast<uint32_t>(fields.size()));
+    out.append(fields.data(), fields.size());
+  }
+
+  inline void appendTextFrame(std::string& out, std::string_view text) {
+    out += 'T';
+    appendRaw(out, static_cast<uint32_t>(text.size()));
+    out.append(text.data(), text.size());
+  }
+
+  /////////////////////////////////////////////////////////
+  // LogDictionary - key names and formats a log holds
+
+  struct LogDictionary {
+    std::vector<bool> keysSent;
+    std::vector<bool> formatsSent;
+
+    void clear() {
+      keysSent.clear();
+      formatsSent.clear();
+    }
+    /*-- mark id sent, returns true if it wasn't --*/
+    static bool mark(std::vector<bool>& sent, size_t id) {
+      if (sent.size() <= id)
+        sent.resize(id + 1, false);
+      if (sent[id])
+        return false;
+      sent[id] = true;
+      return true;
+    }
+  };
+
+  /*-----------------------------------------------------
+    append 'K' and 'F' frames for keys and formats used in
+    frames of body that dict doesn't yet hold
+    - returns false if body doesn't hold whole frames
+  */
+  inline bool appendDictionaryFrames(std::string& out, std::string_view body, LogDictionary& dict) {
+    size_t pos = 0;
+    char tag;
+    while (readBytes(body, pos, tag)) {
+      if (tag == 'S') {
+        uint32_t size;
+        if (!readBytes(body, pos, size) || pos + size > body.size())
+          return false;
+        std::string_view fields = body.substr(pos, size);
+        pos += size;
+        size_t fieldPos = 0;
+        FieldValue f;
+        while (nextField(fields, fieldPos, f)) {
+          const char* name = keyRegistry().find(f.key);
+          if (name != nullptr && LogDictionary::mark(dict.keysSent, f.key))
+            appendKeyFrame(out, f.key, name);
+        }
+      }
+      else if (tag == 'T') {
+        uint32_t size;
+        if (!readBytes(body, pos, size) || pos + size > body.size())
+          return false;
+        pos += size;
+      }
+      else if (tag == 'R') {
+        uint16_t size;
+        FormatId id;
+        size_t header = pos + sizeof(size);
+        if (!readBytes(body, pos, size) || !readBytes(body, pos, id))
+          return false;
+        pos = header + offsetof(DeferredRecord, args) + size;
+        if (pos > body.size())
+          return false;
+        const char* fmt = formatRegistry().find(id);
+        if (fmt != nullptr && LogDictionary::mark(dict.formatsSent, id))
+          appendFormatFrame(out, id, fmt);
+      }
+      else if (tag == 'K') {
+        KeyId id;
+        uint16_t len;
+        if (!readBytes(body, pos, id) || !readBytes(body, pos, len))
+          return false;
+        LogDictionary::mark(dict.keysSent, id);
+        pos += len;
+      }
+      else if (tag == 'F') {
+        FormatId id;
+        uint32_t len;
+        if (!readBytes(body, pos, id) || !readBytes(body, pos, len))
+          return false;
+        if (id < FormatRegistry::maxFormats)
+          LogDictionary::mark(dict.formatsSent, id);
+        pos += len;
+      }
+      else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /////////////////////////////////////////////////////////
+  // BinaryLogSink - adds dictionary frames to binary output
+  // - loggers serialize writes, like those of any sink
+
+  class BinaryLogSink : public ISink {
+  public:
+    BinaryLogSink(ISink* pOut) : pOut_(pOut) {}
+    ISink* out() const { return pOut_; }
+    virtual bool write(std::string_view data) override {
+      frames_.clear();
+      appendDictionaryFrames(frames_, data, dictionary_);
+      if (frames_.size() > 0 && !pOut_->write(frames_)) {
+        dictionary_.clear();
+        return false;
+      }
+      return pOut_->write(data);
+    }
+    virtual void flush() override {
+      pOut_->flush();
+    }
+    virtual void close() override {
+      pOut_->close();
+    }
+    virtual bool sync() override {
+      return pOut_->sync();
+    }
+    virtual bool canSync() const override {
+      return pOut_->canSync();
+    }
+  private:
+    ISink* pOut_;
+    LogDictionary dictionary_;
+    std::string frames_;
+  };
+
+  /*-----------------------------------------------------
+    expand binary log from in, writing each record to out
+    as text lines, prefixed by prefix, or as JSON lines
+    - returns number of records decoded
+  */
+  inline size_t decodeLog(
+    std::istream& in, std::ostream& out,
+    SinkFormat format = SinkFormat::text, const std::string& prefix = "\n  "
+  ) {
+    std::vector<std::string> keys;
+    std::vector<std::string> formats;
+    auto nameOf = [&keys](KeyId id) {
+      return id < keys.size() ? std::string_view(keys[id]) : std::string_view("?");
+    };
+    bool json = format == SinkFormat::json;
+    std::string payload, text, line;
+    size_t count = 0;
+    char tag;
+    while (in.get(tag)) {
+      line.clear();
+      if (tag == 'K') {
+        KeyId id;
+        uint16_t len;
+        in.read(reinterpret_cast<char*>(&id), sizeof(id));
+        in.read(reinterpret_cast<char*>(&len), sizeof(len));
+        if (!in)
+          break;
+        if (keys.size() <= id)
+          keys.resize(id + 1);
+        keys[id].resize(len);
+        in.read(keys[id].data(), len);
+        continue;
+      }
+      if (tag == 'F') {
+        if (!readFormatFrame(in, formats))
+          break;
+        continue;
+      }
+      if (tag == 'S' || tag == 'T') {
+        uint32_t size;
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (!in)
+          break;
+        payload.resize(size);
+        in.read(payload.data(), size);
+        if (!in)
+          break;
+        if (tag == 'S' && json) {
+          appendFieldsJson(line, payload, nameOf);
+        }
+        else if (tag == 'S') {
+          line = prefix;
+          appendFieldsText(line, payload, nameOf);
+        }
+        else if (json) {
+          appendTextJson(line, payload);
+        }
+        else {
+          line = prefix;
+          line += trimText(payload);
+        }
+      }
+      else if (tag == 'R') {
+        DeferredRecord r;
+        if (!readRecordFrame(in, r))
+          break;
+        const char* fmt = r.formatId < formats.size() ? formats[r.formatId].c_str() : nullptr;
+        text.clear();
+        appendFormatted(text, fmt, r);
+        if (json) {
+          appendTextJson(line, text);
+        }
+        else {
+          line = prefix;
+          line += text;
+        }
+      }
+      else {
+        out << (json ? "" : prefix) << "<corrupt binary log>";
+        break;
+      }
+      out << line;
+      ++count;
+    }
+    return count;
+  }
+}
+
+/*---------------------------------------------------------------
+  Field whose name is registered once per call site.
+  - name must be a string literal
+*/
+#define TEST_FIELD(name, value) \
+  Test::makeField([]() { \
+    static const Test::KeyId testLoggerKeyId_ = Test::registerKey(name); \
+    return testLoggerKeyId_; \
+  }(), value)
@@ -9,6 +9,31 @@
 #include "QTestLogger.h"
 #include "../TestUtilities/TestAssertions.h"
 #include "../Display/Display.h"
+#include <sstream>
+#include <cstdio>
+#include <algorithm>
+
+#ifdef TESTLOGGER_HAS_COROUTINES
+
+/*-- minimal fire and forget coroutine, for the postAsync demo --*/
+struct DemoTask {
+  struct promise_type {
+    DemoTask get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+DemoTask asyncSteps(Test::QTestLogger<>& logger, int id, std::atomic<int>& finished) {
+  for (int step = 0; step < 3; ++step)
+    co_await Test::postAsync(logger, Test::MessageBuilder() << "coroutine " << id << ", step " << step);
+  co_await Test::postAsync(logger, Test::MessageBuilder() << "coroutine " << id << " done", Test::Durability::flushed);
+  ++finished;
+}
+
+#endif
 
 int main() {
 
@@ -29,6 +54,9 @@ int main() {
   logger.setPrefix("\n  -- ").setSuffix(" --");
   logger.postDated("Test log #2");
   logger.post("a message");
+  logger.setDateFormat(TestLogger<>::Precision::nano, TestLogger<>::Zone::utc);
+  logger.postDated("UTC nanosecond timestamp");
+  logger.setDateFormat(TestLogger<>::Precision::micro);
   std::cout << "\n";
 
   std::cout << "\n  logger has " << logger.streamCount() << " streams";
@@ -75,12 +103,56 @@ int main() {
   allLogger.post("allLogger here");
   logLevel = Level::all;
 
+  logger.post("\n  -- TEST_POST skips filtered posts without evaluating msg --");
+  size_t evaluations = 0;
+  auto expensive = [&evaluations]() { ++evaluations; return std::string("debug detail"); };
+  logLevel = Level::results;
+  TEST_POST(debugLogger, expensive());
+  TEST_POST(resultsLogger, "results message, evaluations = " + std::to_string(evaluations));
+  logLevel = Level::all;
+  TEST_POST(debugLogger, expensive());
+  logger.post("evaluations of debug message = " + std::to_string(evaluations));
+
+  logger.post("\n  -- call sites, disabled by pattern and listed by hits --");
+  for (int i = 0; i < 3; ++i) {
+    TEST_POST(debugLogger, "noisy loop post #" + std::to_string(i));
+    for (int j = 0; j < 3; ++j)
+      TEST_POST(debugLogger, "very noisy inner post");
+  }
+  size_t silenced = callSites().disable("*very noisy*");
+  TEST_POST(debugLogger, "very noisy inner post");
+  callSites().setShowLocation(true);
+  TEST_POST(demoLogger, "posted with its location");
+  callSites().setShowLocation(false);
+  logger.post("disabled " + std::to_string(silenced) + " site, top sites:");
+  callSites().showTop(std::cout, 3);
+  callSites().clearRules();
+
+  logger.post("\n  -- call sites sampled and rate limited --");
+  for (int i = 0; i < 1000; ++i) {
+    TEST_POST_EVERY_N(debugLogger, 400, "sampled post #" + std::to_string(i));
+    TEST_POST_RATE(debugLogger, 2, "rate limited post #" + std::to_string(i));
+  }
+  postPendingSummaries(debugLogger);
+
   logger.post("\n  -- logging LogMessages --");
   LogMessage msg("github message");
   logger.postDated(msg);
   msg.clear();
   msg.add("send message").add("/with another part").add("/and still another part");
   logger.post(msg);
+  logger.post("LogMessage of " + std::to_string(msg.length()) + " chars, last part at " +
+    std::to_string(msg.find("/and")) + ": " + msg.c_str());
+
+  logger.post("\n  -- building messages with MessageBuilder --");
+  MessageBuilder mb;
+  std::vector<int> ids{ 1, 2, 3 };
+  mb << "count = " << 42 << ", ratio = " << 0.25 << ", ids = " << ids;
+  logger.post(mb);
+  mb.clear();
+  mb << "pair = " << std::pair<std::string, int>("answer", 42) << ", pi = ";
+  mb.addFixed(3.14159265, 3);
+  logger.postDated(mb);
 
   logger.post("\n  -- logging to file stream --");
   std::ofstream oStrm;
@@ -233,5 +305,199 @@ int main() {
   pQlogger->wait();
   std::cout << "\n  after posting and waiting:";
   std::cout << "\n  elapsed microsecs = " << pQlogger->elapsedMicroseconds();
+
+  RingQTestLogger<> ringLogger(&std::cout);
+  ringLogger.post("\n  -- RingQTestLogger posts through lock-free queue --");
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < 3; ++i) {
+    producers.emplace_back([&ringLogger, i]() {
+      ringLogger.post("message from producer #" + std::to_string(i));
+    });
+  }
+  for (auto& t : producers)
+    t.join();
+  ringLogger.wait();
+
+  ringLogger.post("\n  -- deferred posts, formatted by write thread --");
+  for (int i = 0; i < 3; ++i)
+    TEST_POST_DEFERRED(ringLogger, "deferred post #{}, ratio = {}, tag = {}", i, i / 4.0, "demo");
+  ringLogger.wait();
+
+  ringLogger.post("\n  -- deferred posts to binary file deferred.bin --");
+  std::ofstream binStrm("deferred.bin", std::ios::out | std::ios::binary);
+  ringLogger.setDeferredSink(&binStrm);
+  for (int i = 0; i < 3; ++i)
+    TEST_POST_DEFERRED(ringLogger, "binary post #{} of {}", i, 3);
+  ringLogger.wait();
+  ringLogger.setDeferredSink(nullptr);
+  binStrm.close();
+  std::ifstream binIn("deferred.bin", std::ios::in | std::ios::binary);
+  decodeBinaryLog(binIn, std::cout);
+  putline();
+
+  QTestLogger<Level::debug> boundedLogger(&std::cout);
+  boundedLogger.post("\n  -- bounded queue, 4 messages, dropping newest --");
+  boundedLogger.wait();
+  boundedLogger.setPrefix("\n  ");
+  boundedLogger.setCapacity(4, 0, Overflow::dropNewest);
+  for (size_t i = 0; i < 20; ++i)
+    boundedLogger.post("bounded post #" + std::to_string(i));
+  boundedLogger.wait();
+  boundedLogger.post("dropped " + std::to_string(boundedLogger.dropped(Level::debug)) + " debug posts");
+  boundedLogger.wait();
+
+  QTestLogger<> repeatLogger(&std::cout);
+  repeatLogger.post("\n  -- coalescing repeated messages, flushed after 50 ms --");
+  repeatLogger.wait();
+  repeatLogger.setCoalescing(true, 50);
+  for (size_t i = 0; i < 1000; ++i)
+    repeatLogger.post("retrying connection");
+  repeatLogger.post("connected");
+  for (size_t i = 0; i < 5; ++i)
+    repeatLogger.post("heartbeat");
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  repeatLogger.post("coalesced " + std::to_string(repeatLogger.stats().coalesced) + " repeats");
+  repeatLogger.wait();
+
+  repeatLogger.post("\n  -- group commit, results posts fsynced to durable.log --");
+  repeatLogger.wait();
+  {
+    FdSink durableSink("durable.log");
+    QTestLogger<Level::results> durableLogger;
+    durableLogger.addSink(&durableSink);
+    durableLogger.setDurability(Durability::fsynced);
+    std::vector<std::thread> posters;
+    for (size_t i = 0; i < 4; ++i) {
+      posters.emplace_back([&durableLogger, i]() {
+        for (size_t j = 0; j < 25; ++j)
+          durableLogger.post(MessageBuilder() << "\n  result " << j << " from thread " << i);
+      });
+    }
+    for (auto& t : posters)
+      t.join();
+    durableLogger.wait();
+    LoggerStats durableStats = durableLogger.stats();
+    repeatLogger.post(MessageBuilder() << "posted " << durableStats.posted << " durable messages, synced in "
+      << durableStats.commits << " commits");
+    repeatLogger.wait();
+  }
+  std::remove("durable.log");
+
+  repeatLogger.post("\n  -- priority lanes, results posts ahead of a debug backlog --");
+  repeatLogger.wait();
+  std::pair<Drain, size_t> laneSettings[] = { { Drain::fifo, 0 }, { Drain::strict, 0 }, { Drain::strict, 1000 } };
+  for (auto [drain, syncDepth] : laneSettings) {
+    std::ostringstream laneStrm;
+    QTestLogger<Level::all> laneLogger(&laneStrm);
+    laneLogger.setLanes(drain, syncDepth);
+    for (size_t i = 0; i < 20000; ++i)
+      laneLogger.postAt(Level::debug, MessageBuilder() << "debug detail #" << i);
+    laneLogger.postAt(Level::results, "result: test passed");
+    laneLogger.wait();
+    std::string text = laneStrm.str();
+    size_t ahead = std::count(text.begin(), text.begin() + text.find("result:"), '\n') - 1;
+    repeatLogger.post(MessageBuilder() << (drain == Drain::fifo ? "fifo" : "strict") << ", syncDepth " << syncDepth
+      << ": result written after " << ahead
+      << " of 20000 debug posts, " << laneLogger.stats().synced << " written synchronously");
+    repeatLogger.wait();
+  }
+
+  std::ostringstream fanOutStrm;
+  QTestLogger<> fanOutLogger(&std::cout);
+  fanOutLogger.addStream(&fanOutStrm);
+  fanOutLogger.setFanOut(true, 1024 * 1024);
+  fanOutLogger.post("\n  -- fan-out mode, one writer thread per stream --");
+  for (size_t i = 0; i < 3; ++i)
+    fanOutLogger.post("fan-out post #" + std::to_string(i));
+  fanOutLogger.wait();
+  for (auto& stats : fanOutLogger.sinkStats()) {
+    fanOutLogger.post(
+      (stats.pStrm == &std::cout ? "std::cout" : "ostringstream") + std::string(" wrote ") +
+      std::to_string(stats.writtenMessages) + " messages, lag " + std::to_string(stats.lagBytes) + " bytes"
+    );
+  }
+  fanOutLogger.wait();
+
+  std::cout.flush();
+  MemorySink memorySink;
+  QTestLogger<> sinkLogger;
+  sinkLogger.addSink(&stdoutSink());
+  sinkLogger.addSink(&memorySink);
+  sinkLogger.post("\n  -- native sinks, stdout descriptor and memory --");
+  sinkLogger.post("posted to FdSink and MemorySink");
+  sinkLogger.wait();
+  sinkLogger.post("memory sink holds " + std::to_string(memorySink.str().size()) + " bytes");
+  sinkLogger.wait();
+
+  std::ostringstream jsonStrm;
+  MemorySink binarySink;
+  QTestLogger<> fieldLogger(&std::cout);
+  fieldLogger.addStream(&jsonStrm, SinkFormat::json);
+  fieldLogger.addSink(&binarySink, SinkFormat::binary);
+  fieldLogger.post("\n  -- structured posts, rendered as text, JSON, and binary --");
+  static const Key user("user");
+  for (int i = 0; i < 3; ++i) {
+    fieldLogger.post(
+      FieldRecord("request done") << TEST_FIELD("status", 200 + i) << user("Jim Fawcett") << TEST_FIELD("ms", 1.5 * i)
+    );
+  }
+  fieldLogger.postDated(FieldRecord("shutting down") << TEST_FIELD("clean", true));
+  fieldLogger.wait();
+  std::cout << "\n\n  JSON stream:\n" << jsonStrm.str();
+  std::string binary = binarySink.str();
+  std::istringstream binaryIn(binary);
+  std::cout << "\n  binary sink, " << binary.size() << " bytes, decoded:";
+  decodeLog(binaryIn, std::cout);
+  std::cout << "\n";
+
+  std::ostringstream statsStrm;
+  QTestLogger<> statsLogger(&statsStrm);
+  for (size_t i = 0; i < 1000; ++i)
+    statsLogger.post(MessageBuilder() << "\n  stats post #" << i);
+  statsLogger.wait();
+  LoggerStats stats = statsLogger.stats();
+  sinkLogger.post("\n  -- queue statistics, 1000 posts to an ostringstream --");
+  sinkLogger.setPrefix("\n  ");
+  sinkLogger.post(MessageBuilder() << "posted " << stats.posted << " messages, " << stats.postedBytes
+    << " bytes, written in " << stats.batches << " batches");
+  sinkLogger.post(MessageBuilder() << "queue depth " << stats.queueDepth << ", high water " << stats.highWaterDepth);
+  sinkLogger.post(MessageBuilder() << "latency p50 " << stats.latency.percentile(0.5) << " ns, p99 "
+    << stats.latency.percentile(0.99) << " ns, max " << stats.latency.max() << " ns");
+  sinkLogger.post(MessageBuilder().add("write thread busy ").addFixed(100.0 * stats.busyFraction(), 1) << "%");
+  for (auto& sink : stats.sinks)
+    sinkLogger.post(MessageBuilder() << "stream wrote " << sink.writtenMessages << " messages, " << sink.writtenBytes << " bytes");
+  sinkLogger.wait();
+
+  sinkLogger.post("\n  -- crash flush, fatal signals write unwritten messages to stdout --");
+  sinkLogger.enableCrashFlush({ 1 });
+  sinkLogger.post("crash flush enabled, SIGSEGV here would still show this line");
+  sinkLogger.wait();
+  sinkLogger.disableCrashFlush();
+
+#ifdef TESTLOGGER_HAS_COROUTINES
+  sinkLogger.post("\n  -- postAsync, coroutines resumed by the write thread --");
+  sinkLogger.wait();
+  std::atomic<int> finished{ 0 };
+  for (int id = 0; id < 3; ++id)
+    asyncSteps(sinkLogger, id, finished);
+  while (finished.load() < 3)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  sinkLogger.post(std::to_string(finished.load()) + " coroutines finished, no thread blocked");
+  sinkLogger.wait();
+
+  sinkLogger.post("\n  -- postAsync into a full queue, posts from completions queue past capacity, never block --");
+  sinkLogger.wait();
+  size_t droppedBefore = sinkLogger.dropped();
+  sinkLogger.setCapacity(2, 0, Overflow::block);
+  finished = 0;
+  for (int id = 0; id < 6; ++id)
+    asyncSteps(sinkLogger, id, finished);
+  while (finished.load() < 6)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  sinkLogger.setCapacity(0, 0, Overflow::block);
+  sinkLogger.post(std::to_string(finished.load()) + " coroutines finished, " +
+    std::to_string(sinkLogger.dropped() - droppedBefore) + " of their posts dropped");
+  sinkLogger.wait();
+#endif
   putline(2);
 }
\ No newline at end of file
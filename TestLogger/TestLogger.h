@@ -1,7 +1,7 @@
 #pragma once
 /////////////////////////////////////////////////////////////////////////
 // TestLogger.h - Logs to multiple streams                             //
-// ver 1.1                                                             //
+// ver 1.2                                                             //
 // Jim Fawcett, Emeritus Teaching Professor, EECS, Syracuse University //
 /////////////////////////////////////////////////////////////////////////
 /*
@@ -9,12 +9,37 @@
   ---------------------------
    Package provides ITestLogger interface, TestLogger class, and two factories:
    - Write log messages to multiple streams
-   - Accept strings or messages convertible to string
+   - Accept strings, MessageBuilders, or messages convertible to string
    - TestLogger<N> provides:
-     - post(msg) and postDated(msg)
+     - post(msg) and postDated(msg), msg a std::string or MessageBuilder
      - addStream(pStrm), removeStream(pStrm), streamCount()
+     - addSink(pSink), removeSink(pSink)
      - clear()
      - setPrefix(prfx) and setSuffix(suffx)
+     - setDateFormat(precision, zone)
+   - Many threads may post through one TestLogger concurrently.
+   - Output goes to ISink's, see LogSinks.h.  addSink takes a native
+     sink, e.g., FdSink, that writes without iostream overhead, and
+     addStream wraps its std::ostream in an OStreamSink.  The caller
+     owns both streams and sinks.
+   - postDated appends an ISO-8601 timestamp with micro or nanosecond
+     precision, local or UTC, from a per-thread TimestampFormatter.
+   - MessageBuilder, see MessageBuilder.h, formats numbers, strings,
+     and containers into a stack buffer, and post reads that buffer in
+     place.  LogMessage keeps the std::string members callers used,
+     size(), length(), c_str(), find(), +, ==, and << to an ostream, on
+     top of MessageBuilder.  It is no longer a std::string, so passing
+     it where a const std::string& is expected converts it to a copy.
+   - Each sink counts the messages and bytes written to it, updated
+     under its lock, see sinkTotals().
+   - Prefix, message, timestamp, and suffix are assembled into one
+     per-thread buffer with a single pass, so steady state posts don't
+     allocate.
+   - post(FieldRecord) logs typed key-value fields, see StructuredLog.h.
+     Each stream has a SinkFormat, given to addStream or addSink, and
+     every post is rendered once per format in use: text, one JSON
+     object per line, or binary frames.  Binary sinks are wrapped in a
+     BinaryLogSink, which sends each field name to them once.
 
    Requires:
   -----------
@@ -30,10 +55,35 @@
    ITestLogger.h
    TestLogger.h, TestLogger.cpp (only for demonstration)
    DateTime.h, DateTime.cpp
+   TimestampFormatter.h
+   LogSinks.h
+   LoggerStats.h
+   MessageBuilder.h, LogRecord.h
+   StructuredLog.h, DeferredLog.h
    TypeTraits.h
 
    Maintenance History:
   ----------------------
+   ver 1.2 : 16 Oct 2026
+   - logLevel is now an atomic LevelMask, checked once at the top of
+     post and postDated, before any message formatting
+   - added TEST_POST and TEST_POST_DATED macros, see ITestLogger.h
+   - TestLogger is safe for concurrent posts: per-thread formatting
+     buffers replace the shared composite_ member, and each stream
+     has its own lock so messages are written whole
+   - clear() no longer skips streams while erasing them
+   - postDated uses TimestampFormatter instead of DateTime::now(),
+     added setDateFormat(precision, zone)
+   - streams are written through the ISink interface, added addSink
+     and removeSink for native sinks
+   - post and postDated assemble prefix, message, timestamp, and
+     suffix in one pass, postDated no longer copies the message first
+   - added post and postDated overloads for MessageBuilder, LogMessage
+     now derives from MessageBuilder instead of std::string, keeping
+     str, length, c_str, find, +, and ==
+   - sinks count messages and bytes written
+   - added post and postDated overloads for FieldRecord, and a
+     SinkFormat argument to addStream and addSink
    ver 1.1 : 30 Jan 2020
    - removed template argument size_t N on loggers
      That argument remains for factories so we can more than one "singleTon" logger
@@ -42,19 +92,32 @@
 */
 
 #include "ITestLogger.h"
+#include "LoggerStats.h"
 #include "../DateTime/DateTime.h"
+#include "../DateTime/TimestampFormatter.h"
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <vector>
+#include <array>
 #include <algorithm>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
 
 namespace Test {
 
   /////////////////////////////////////////////////////////
   // TestLogger class
   // - note virtual public inheritance
+  // - safe for concurrent posts from many threads:
+  //   - each thread formats into its own thread_local buffer
+  //   - each stream has its own lock, held only while one
+  //     formatted message is written, so lines never interleave
+  //   - streams, prefix, and suffix are guarded by a shared_mutex,
+  //     held shared by posts and exclusive by the setters
 
   template<Level L = Level::all>
   class TestLogger : virtual public ITestLogger<L> {
@@ -66,22 +129,65 @@ namespace Test {
       addStream(pStrm);
     }
     virtual ~TestLogger();
-    virtual void addStream(std::ostream* pOstream) override;
+    virtual void addStream(std::ostream* pOstream, SinkFormat format = SinkFormat::text) override;
     virtual bool removeStream(std::ostream* pStrm) override;
+    virtual void addSink(ISink* pSink, SinkFormat format = SinkFormat::text) override;
+    virtual bool removeSink(ISink* pSink) override;
     virtual void clear() override;
     virtual size_t streamCount() override;
     virtual ITestLogger<L>& post(const std::string& msg) override;
     virtual ITestLogger<L>& postDated(const std::string& msg) override;
+    virtual ITestLogger<L>& post(const MessageBuilder& msg) override;
+    virtual ITestLogger<L>& postDated(const MessageBuilder& msg) override;
+    virtual ITestLogger<L>& post(const FieldRecord& rec) override;
+    virtual ITestLogger<L>& postDated(const FieldRecord& rec) override;
     virtual ITestLogger<L>& setPrefix(const std::string& prefix) override;
     virtual ITestLogger<L>& setSuffix(const std::string& suffix) override;
     virtual std::string level() override;
+    using Precision = Utilities::TimestampFormatter::Precision;
+    using Zone = Utilities::TimestampFormatter::Zone;
+    TestLogger<L>& setDateFormat(Precision p, Zone z = Zone::local);
+    std::vector<SinkStats> sinkTotals();
   protected:
-    void corePost(const std::string& msg);
-    Streams streams_;
+    struct Sink {
+      std::ostream* pStrm = nullptr;
+      ISink* pSink = nullptr;
+      std::unique_ptr<OStreamSink> pAdapter;
+      std::unique_ptr<std::mutex> pLock = std::make_unique<std::mutex>();
+      size_t messages = 0;  // guarded by pLock
+      size_t bytes = 0;
+      SinkFormat format = SinkFormat::text;
+      std::unique_ptr<BinaryLogSink> pBinary;
+      ISink* writer() const { return pBinary ? pBinary.get() : pSink; }
+    };
+    using Sinks = std::vector<Sink>;
+    using NativeSinks = std::vector<ISink*>;
+    using Rendered = std::array<std::string, sinkFormatCount>;
+
+    static Sink makeSink(std::ostream* pStrm, SinkFormat format = SinkFormat::text);
+    static Sink makeSink(ISink* pSink, SinkFormat format = SinkFormat::text);
+    static void setFormat(Sink& sink, SinkFormat format);
+    void updateFormats();
+    void corePost(std::string_view msg, std::string_view stamp = std::string_view());
+    void coreDated(std::string_view msg);
+    void coreFields(std::string_view fields);
+    template<typename Buffer>
+    void assemble(Buffer& out, std::string_view msg, std::string_view stamp);
+    void renderText(Rendered& out, std::string_view text);
+    void renderFields(Rendered& out, std::string_view fields);
+    void writeSinks(const char* data, size_t size, size_t messages = 1);
+    void writeSinks(const Rendered& out, size_t messages = 1);
+    Streams streamList();
+    NativeSinks sinkList();
+    size_t formatTimestamp(char* buffer, size_t size);
+    Sinks streams_;
+    unsigned formats_ = 0;  // formatBit of each stream's format, guarded by streamsMtx_
+    std::shared_mutex streamsMtx_;
     std::string prefix_ = "\n  ";
     std::string suffix_ = "";
     Utilities::DateTime dt;
-    std::string composite_;
+    std::atomic<Precision> datePrecision_{ Precision::micro };
+    std::atomic<Zone> dateZone_{ Zone::local };
   };
 
   /*-- remove all streams, closing file streams --*/
@@ -89,14 +195,76 @@ namespace Test {
   TestLogger<L>::~TestLogger() {
     clear();
   }
-  /*-- add ostream pointer, opens new log channel --*/
+  /*-- sink entry writing to pStrm through an OStreamSink --*/
+  template<Level L>
+  typename TestLogger<L>::Sink TestLogger<L>::makeSink(std::ostream* pStrm, SinkFormat format) {
+    Sink sink;
+    sink.pStrm = pStrm;
+    sink.pAdapter = std::make_unique<OStreamSink>(pStrm);
+    sink.pSink = sink.pAdapter.get();
+    setFormat(sink, format);
+    return sink;
+  }
+  /*-- sink entry writing to native sink pSink --*/
+  template<Level L>
+  typename TestLogger<L>::Sink TestLogger<L>::makeSink(ISink* pSink, SinkFormat format) {
+    Sink sink;
+    sink.pSink = pSink;
+    setFormat(sink, format);
+    return sink;
+  }
+  /*-- binary sinks write through a BinaryLogSink, adding key and format frames --*/
+  template<Level L>
+  void TestLogger<L>::setFormat(Sink& sink, SinkFormat format) {
+    sink.format = format;
+    if (format == SinkFormat::binary)
+      sink.pBinary = std::make_unique<BinaryLogSink>(sink.pSink);
+    else
+      sink.pBinary.reset();
+  }
+  /*-- recompute formats in use, caller holds streamsMtx_ exclusive --*/
+  template<Level L>
+  void TestLogger<L>::updateFormats() {
+    formats_ = 0;
+    for (auto& sink : streams_)
+      formats_ |= formatBit(sink.format);
+  }
+  /*-- add ostream pointer, opens new log channel rendered in format --*/
+  template<Level L>
+  void TestLogger<L>::addStream(std::ostream* pOstream, SinkFormat format) {
+    std::unique_lock<std::shared_mutex> l(streamsMtx_);
+    streams_.push_back(makeSink(pOstream, format));
+    updateFormats();
+  }
+  /*-- add native sink, opens new log channel rendered in format --*/
   template<Level L>
-  void TestLogger<L>::addStream(std::ostream* pOstream) {
-    streams_.push_back(pOstream);
+  void TestLogger<L>::addSink(ISink* pSink, SinkFormat format) {
+    std::unique_lock<std::shared_mutex> l(streamsMtx_);
+    streams_.push_back(makeSink(pSink, format));
+    updateFormats();
+  }
+  /*-- remove native sink after flushing it, caller closes it --*/
+  template<Level L>
+  bool TestLogger<L>::removeSink(ISink* pSink) {
+    std::unique_lock<std::shared_mutex> l(streamsMtx_);
+    auto iter = std::find_if(
+      streams_.begin(), streams_.end(),
+      [pSink](const Sink& s) { return s.pStrm == nullptr && s.pSink == pSink; }
+    );
+    if (iter == streams_.end())
+      return false;
+    {
+      std::lock_guard<std::mutex> sl(*iter->pLock);
+      iter->writer()->flush();
+    }
+    streams_.erase(iter);
+    updateFormats();
+    return true;
   }
   /*-- remove ostream pointer, closes log channel --*/
   template<Level L>
   bool TestLogger<L>::removeStream(std::ostream* pStrm) {
+    std::unique_lock<std::shared_mutex> l(streamsMtx_);
     try {
       std::ofstream* pFile = dynamic_cast<std::ofstream*>(pStrm);
       if (pFile != nullptr) {
@@ -113,57 +281,259 @@ namespace Test {
       // Stream in heap already deleted by std::unique_ptr
       // That happens when logger goes out of scope
     }
-    Streams::iterator iter = std::find(streams_.begin(), streams_.end(), pStrm);
+    auto iter = std::find_if(
+      streams_.begin(), streams_.end(), [pStrm](const Sink& s) { return s.pStrm == pStrm; }
+    );
     if (iter == streams_.end())
       return false;
     streams_.erase(iter);
+    updateFormats();
     return true;
   }
+  /*-- snapshot of stream pointers --*/
+  template<Level L>
+  typename TestLogger<L>::Streams TestLogger<L>::streamList() {
+    std::shared_lock<std::shared_mutex> l(streamsMtx_);
+    Streams strms;
+    for (auto& sink : streams_) {
+      if (sink.pStrm != nullptr)
+        strms.push_back(sink.pStrm);
+    }
+    return strms;
+  }
+  /*-- snapshot of native sink pointers --*/
+  template<Level L>
+  typename TestLogger<L>::NativeSinks TestLogger<L>::sinkList() {
+    std::shared_lock<std::shared_mutex> l(streamsMtx_);
+    NativeSinks sinks;
+    for (auto& sink : streams_) {
+      if (sink.pStrm == nullptr)
+        sinks.push_back(sink.pSink);
+    }
+    return sinks;
+  }
   /*-- remove all streams, reset prefix and suffix --*/
   template<Level L>
   void TestLogger<L>::clear() {
-    for (auto pStrm : streams_)
+    for (auto pStrm : streamList())
       removeStream(pStrm);
+    for (auto pSink : sinkList())
+      removeSink(pSink);
+    std::unique_lock<std::shared_mutex> l(streamsMtx_);
     prefix_ = "\n  ";
     suffix_ = "";
   }
   /*-- return number of open log channels --*/
   template<Level L>
   size_t TestLogger<L>::streamCount() {
+    std::shared_lock<std::shared_mutex> l(streamsMtx_);
     return streams_.size();
   }
-  /*-- private write log message to all channels --*/
+  /*-- write messages to every stream, caller holds streamsMtx_ shared --*/
+  template<Level L>
+  void TestLogger<L>::writeSinks(const char* data, size_t size, size_t messages) {
+    for (auto& sink : streams_) {
+      std::lock_guard<std::mutex> l(*sink.pLock);
+      if (sink.writer()->write(std::string_view(data, size))) {
+        sink.messages += messages;
+        sink.bytes += size;
+      }
+    }
+  }
+  /*-- write each stream its format's rendering, caller holds streamsMtx_ shared --*/
   template<Level L>
-  void TestLogger<L>::corePost(const std::string& msg) {
-    if (levelValue(L) & levelValue(logLevel)) {
-      composite_ = prefix_ + msg + suffix_;
-      for (auto pStrm : streams_) {
-        (*pStrm) << composite_;
+  void TestLogger<L>::writeSinks(const Rendered& out, size_t messages) {
+    for (auto& sink : streams_) {
+      const std::string& data = out[formatIndex(sink.format)];
+      if (data.empty())
+        continue;
+      std::lock_guard<std::mutex> l(*sink.pLock);
+      if (sink.writer()->write(data)) {
+        sink.messages += messages;
+        sink.bytes += data.size();
       }
     }
   }
+  /*-----------------------------------------------------
+    append assembled text post to out in each format in
+    use, caller holds streamsMtx_ shared
+  */
+  template<Level L>
+  void TestLogger<L>::renderText(Rendered& out, std::string_view text) {
+    if (formats_ & formatBit(SinkFormat::text))
+      out[formatIndex(SinkFormat::text)].append(text.data(), text.size());
+    if (formats_ & formatBit(SinkFormat::json))
+      appendTextJson(out[formatIndex(SinkFormat::json)], text);
+    if (formats_ & formatBit(SinkFormat::binary))
+      appendTextFrame(out[formatIndex(SinkFormat::binary)], text);
+  }
+  /*-----------------------------------------------------
+    append encoded fields to out in each format in use,
+    caller holds streamsMtx_ shared
+  */
+  template<Level L>
+  void TestLogger<L>::renderFields(Rendered& out, std::string_view fields) {
+    if (formats_ & formatBit(SinkFormat::text)) {
+      std::string& text = out[formatIndex(SinkFormat::text)];
+      text += prefix_;
+      appendFieldsText(text, fields);
+      text += suffix_;
+    }
+    if (formats_ & formatBit(SinkFormat::json))
+      appendFieldsJson(out[formatIndex(SinkFormat::json)], fields);
+    if (formats_ & formatBit(SinkFormat::binary))
+      appendFieldsFrame(out[formatIndex(SinkFormat::binary)], fields);
+  }
+  /*-- messages and bytes written to each stream --*/
+  template<Level L>
+  std::vector<SinkStats> TestLogger<L>::sinkTotals() {
+    std::shared_lock<std::shared_mutex> l(streamsMtx_);
+    std::vector<SinkStats> totals;
+    for (auto& sink : streams_) {
+      std::lock_guard<std::mutex> sl(*sink.pLock);
+      SinkStats s;
+      s.pSink = sink.pSink;
+      s.pStrm = sink.pStrm;
+      s.writtenMessages = sink.messages;
+      s.writtenBytes = sink.bytes;
+      totals.push_back(s);
+    }
+    return totals;
+  }
+  /*-----------------------------------------------------
+    append prefix, msg, " : " stamp if not empty, and
+    suffix to out, caller holds streamsMtx_ shared
+    - Buffer is std::string or LogRecord
+  */
+  template<Level L>
+  template<typename Buffer>
+  void TestLogger<L>::assemble(Buffer& out, std::string_view msg, std::string_view stamp) {
+    size_t dated = stamp.empty() ? 0 : 3 + stamp.size();
+    out.reserve(out.size() + prefix_.size() + msg.size() + dated + suffix_.size());
+    out.append(prefix_).append(msg);
+    if (dated > 0)
+      out.append(" : ").append(stamp);
+    out.append(suffix_);
+  }
+  /*-----------------------------------------------------
+    private write log message to all channels
+    - when every stream is text, the assembled message is
+      written as is
+  */
+  template<Level L>
+  void TestLogger<L>::corePost(std::string_view msg, std::string_view stamp) {
+    thread_local std::string composite;
+    composite.clear();
+    std::shared_lock<std::shared_mutex> l(streamsMtx_);
+    assemble(composite, msg, stamp);
+    if (formats_ == formatBit(SinkFormat::text)) {
+      writeSinks(composite.data(), composite.size());
+      return;
+    }
+    thread_local Rendered rendered;
+    for (auto& text : rendered)
+      text.clear();
+    renderText(rendered, composite);
+    writeSinks(rendered);
+  }
+  /*-- private write encoded fields to all channels --*/
+  template<Level L>
+  void TestLogger<L>::coreFields(std::string_view fields) {
+    thread_local Rendered rendered;
+    for (auto& text : rendered)
+      text.clear();
+    std::shared_lock<std::shared_mutex> l(streamsMtx_);
+    renderFields(rendered, fields);
+    writeSinks(rendered);
+  }
   /*-- write log message to all channels --*/
   template<Level L>
   ITestLogger<L>& TestLogger<L>::post(const std::string& msg) {
+    if (!logLevel.enabled(L))
+      return *this;
     corePost(msg);
     return *this;
   }
+  /*-- private write dated log message to all channels --*/
+  template<Level L>
+  void TestLogger<L>::coreDated(std::string_view msg) {
+    char stamp[Utilities::TimestampFormatter::bufferSize];
+    size_t len = formatTimestamp(stamp, sizeof(stamp));
+    corePost(msg, std::string_view(stamp, len));
+  }
   /*-- write dated log message to all channels --*/
   template<Level L>
   ITestLogger<L>& TestLogger<L>::postDated(const std::string& msg) {
-    composite_ = msg + " : " + dt.now();
-    corePost(composite_);
+    if (!logLevel.enabled(L))
+      return *this;
+    coreDated(msg);
+    return *this;
+  }
+  /*-- write built message to all channels, reading it in place --*/
+  template<Level L>
+  ITestLogger<L>& TestLogger<L>::post(const MessageBuilder& msg) {
+    if (!logLevel.enabled(L))
+      return *this;
+    corePost(msg.view());
+    return *this;
+  }
+  /*-- write dated built message to all channels --*/
+  template<Level L>
+  ITestLogger<L>& TestLogger<L>::postDated(const MessageBuilder& msg) {
+    if (!logLevel.enabled(L))
+      return *this;
+    coreDated(msg.view());
+    return *this;
+  }
+  /*-- write structured record to all channels --*/
+  template<Level L>
+  ITestLogger<L>& TestLogger<L>::post(const FieldRecord& rec) {
+    if (!logLevel.enabled(L))
+      return *this;
+    coreFields(rec.bytes());
+    return *this;
+  }
+  /*-- write structured record to all channels, with a time field first --*/
+  template<Level L>
+  ITestLogger<L>& TestLogger<L>::postDated(const FieldRecord& rec) {
+    if (!logLevel.enabled(L))
+      return *this;
+    char stamp[Utilities::TimestampFormatter::bufferSize];
+    size_t len = formatTimestamp(stamp, sizeof(stamp));
+    LogRecord fields;
+    encodeField(fields, KeyRegistry::timeKey, std::string_view(stamp, len));
+    fields.append(rec.bytes());
+    coreFields(fields.view());
+    return *this;
+  }
+  /*-- format timestamp using calling thread's formatter, returns length --*/
+  template<Level L>
+  size_t TestLogger<L>::formatTimestamp(char* buffer, size_t size) {
+    thread_local Utilities::TimestampFormatter formatter;
+    return formatter.format(
+      buffer, size,
+      datePrecision_.load(std::memory_order_relaxed),
+      dateZone_.load(std::memory_order_relaxed)
+    );
+  }
+  /*-- set postDated timestamp precision and time zone --*/
+  template<Level L>
+  TestLogger<L>& TestLogger<L>::setDateFormat(Precision p, Zone z) {
+    datePrecision_.store(p, std::memory_order_relaxed);
+    dateZone_.store(z, std::memory_order_relaxed);
     return *this;
   }
   /*-- set new message prefix --*/
   template<Level L>
   ITestLogger<L>& TestLogger<L>::setPrefix(const std::string& prefix) {
+    std::unique_lock<std::shared_mutex> l(streamsMtx_);
     prefix_ = prefix;
     return *this;
   }
   /*-- set new message suffix --*/
   template<Level L>
   ITestLogger<L>& TestLogger<L>::setSuffix(const std::string& suffix) {
+    std::unique_lock<std::shared_mutex> l(streamsMtx_);
     suffix_ = suffix;
     return *this;
   }
@@ -246,24 +616,65 @@ namespace Test {
   /////////////////////////////////////////////////
   // LogMessage class
   // - required to have cast to string method
+  // - built on MessageBuilder, so add accepts numbers and
+  //   containers as well as strings, and posts don't copy
+  // - keeps the std::string members callers of the
+  //   std::string based LogMessage used
 
-  class LogMessage : public std::string {
+  class LogMessage : public MessageBuilder {
   public:
-    LogMessage(const std::string& preamble) {
-      *this += preamble;
+    static constexpr size_t npos = std::string::npos;
+
+    LogMessage() {}
+    LogMessage(const std::string& preamble) : MessageBuilder(preamble) {}
+    template<typename T>
+    LogMessage& add(const T& content) {
+      MessageBuilder::add(content);
+      return *this;
     }
-    LogMessage& add(const std::string& content) {
-      *this += content;
+    LogMessage& operator+=(const std::string& content) {
+      MessageBuilder::add(content);
       return *this;
     }
-    operator std::string() {
-      return static_cast<std::string>(*this);
+    operator std::string() const {
+      return toString();
+    }
+    std::string str() const {
+      return toString();
+    }
+    size_t length() const {
+      return size();
+    }
+    /*-- text followed by a null, not counted in size() --*/
+    const char* c_str() const {
+      return text_.c_str();
+    }
+    size_t find(std::string_view text, size_t pos = 0) const {
+      return view().find(text, pos);
+    }
+    size_t find(char c, size_t pos = 0) const {
+      return view().find(c, pos);
     }
-    std::string toString() {
-      return static_cast<std::string>(*this);
+    bool operator==(std::string_view text) const {
+      return view() == text;
     }
-    void clear() {
-      *this = static_cast<LogMessage>("");
+    bool operator!=(std::string_view text) const {
+      return view() != text;
     }
   };
+
+  inline std::string operator+(const LogMessage& msg, std::string_view text) {
+    std::string result(msg.view());
+    return result.append(text);
+  }
+  inline std::string operator+(std::string_view text, const LogMessage& msg) {
+    std::string result(text);
+    return result.append(msg.view());
+  }
+  inline std::string operator+(const LogMessage& msg, const char* pText) {
+    return msg + std::string_view(pText);
+  }
+  inline std::string operator+(const char* pText, const LogMessage& msg) {
+    return std::string_view(pText) + msg;
+  }
 }
\ No newline at end of file